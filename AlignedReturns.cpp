@@ -0,0 +1,100 @@
+#include "AlignedReturns.hpp"
+#include "OnlineStats.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+static std::int64_t bucketOf(std::int64_t ts, std::int64_t bucketSeconds) {
+    if (bucketSeconds <= 0) return ts;
+    std::int64_t q = ts / bucketSeconds;
+    if (ts % bucketSeconds < 0) --q;   // division entière vers -inf
+    return q * bucketSeconds;
+}
+
+AlignedReturns AlignedReturns::join(const std::vector<const PriceHistory*>& histories, const AlignOptions& options) {
+    const std::size_t n = histories.size();
+    AlignedReturns out;
+    out.missing_ = options.missing;
+    out.labels_.reserve(n);
+    for (const PriceHistory* h : histories) {
+        if (!h) throw std::invalid_argument("AlignedReturns::join: null history.");
+        if (h->returnTimestamps.size() != h->logReturns.size()) {
+            throw std::invalid_argument("AlignedReturns::join: returnTimestamps/logReturns size mismatch.");
+        }
+        out.labels_.push_back(h->ticker);
+    }
+    if (n == 0) return out;
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const std::int64_t none = std::numeric_limits<std::int64_t>::max();
+    std::vector<std::size_t> cursor(n, 0);
+    std::vector<double> row(n);
+
+    // fusion k-voies : à chaque pas, la plus petite tranche parmi les têtes de série
+    while (true) {
+        std::int64_t next = none;
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto& ts = histories[i]->returnTimestamps;
+            if (cursor[i] < ts.size()) next = std::min(next, bucketOf(ts[cursor[i]], options.bucketSeconds));
+        }
+        if (next == none) break;
+
+        std::size_t present = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto& ts = histories[i]->returnTimestamps;
+            std::size_t& c = cursor[i];
+            row[i] = nan;
+            // plusieurs rendements dans la même tranche : le dernier l'emporte
+            while (c < ts.size() && bucketOf(ts[c], options.bucketSeconds) == next) {
+                row[i] = histories[i]->logReturns[c];
+                ++c;
+            }
+            if (!std::isnan(row[i])) ++present;
+        }
+
+        if (options.missing == MissingReturns::Intersection && present < n) continue;
+        out.timestamps_.push_back(next);
+        out.values_.insert(out.values_.end(), row.begin(), row.end());
+    }
+    return out;
+}
+
+CovarianceResult AlignedReturns::covariance(const CovarianceOptions& options) const {
+    if (missing_ != MissingReturns::Intersection) {
+        throw std::invalid_argument("AlignedReturns::covariance: requires Intersection alignment (no gaps).");
+    }
+    return computeCovariance(values_.data(), rows(), series(), labels_, options);
+}
+
+CorrelationMatrix AlignedReturns::correlation(std::size_t minOverlap) const {
+    const std::size_t n = series();
+    const std::size_t T = rows();
+    CorrelationMatrix corr(labels_);
+    if (n == 0) return corr;
+
+    if (missing_ == MissingReturns::Intersection) {
+        if (T < minOverlap || T < 2) throw std::runtime_error("Not enough aligned returns to compute correlation matrix.");
+        // matrice dense sans trou : produit X'X par blocs (CovarianceEngine)
+        return computeCovariance(values_.data(), T, n, labels_).correlation;
+    }
+
+    // PairwiseComplete : co-moment de Welford sur les dates communes à la paire (une passe)
+    for (std::size_t i = 0; i < n; ++i) {
+        double* dst = corr.row(i);
+        for (std::size_t j = i + 1; j < n; ++j) {
+            RunningCoMoment pair;
+            for (std::size_t t = 0; t < T; ++t) {
+                const double* r = row(t);
+                if (std::isnan(r[i]) || std::isnan(r[j])) continue;
+                pair.add(r[i], r[j]);
+            }
+            if (pair.count() < minOverlap || pair.count() < 2) {
+                throw std::runtime_error("Not enough overlapping returns for " + labels_[i] + "/" + labels_[j] +
+                                         " (" + std::to_string(pair.count()) + ").");
+            }
+            dst[j - i] = pair.correlation();
+        }
+    }
+    return corr;
+}
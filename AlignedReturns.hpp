@@ -0,0 +1,60 @@
+#ifndef ALIGNED_RETURNS_HPP
+#define ALIGNED_RETURNS_HPP
+
+#include "CorrelationMatrix.hpp"
+#include "CovarianceEngine.hpp"
+#include "PriceHistory.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Traitement des dates où une série n'a pas de rendement (férié local, close null)
+enum class MissingReturns {
+    Intersection,       // seules les dates communes à toutes les séries
+    PairwiseComplete    // union des dates ; chaque paire utilise ses dates communes
+};
+
+struct AlignOptions {
+    MissingReturns missing = MissingReturns::Intersection;
+    // Les rendements sont appariés par tranche de bucketSeconds (jour UTC par défaut :
+    // les barres journalières de places différentes n'ont pas le même horodatage).
+    // 0 = horodatages exacts.
+    std::int64_t bucketSeconds = 86400;
+};
+
+// Matrice dense T x n des log-returns, une ligne par date, une colonne par série,
+// obtenue par fusion k-voies des (returnTimestamps, logReturns) de chaque historique.
+// Construite une fois puis partagée par les statistiques en aval.
+class AlignedReturns {
+public:
+    AlignedReturns() = default;
+
+    static AlignedReturns join(const std::vector<const PriceHistory*>& histories, const AlignOptions& options = {});
+
+    std::size_t rows() const { return timestamps_.size(); }
+    std::size_t series() const { return labels_.size(); }
+    MissingReturns missing() const { return missing_; }
+
+    const std::vector<std::string>& labels() const { return labels_; }
+    const std::vector<std::int64_t>& timestamps() const { return timestamps_; }   // début de tranche
+    // ligne t : series() valeurs, NaN = pas de rendement (PairwiseComplete seulement)
+    const double* row(std::size_t t) const { return values_.data() + t * labels_.size(); }
+    double operator()(std::size_t t, std::size_t i) const { return values_[t * labels_.size() + i]; }
+
+    // Corrélation sur les dates communes (toutes, ou par paire). runtime_error si moins
+    // de minOverlap dates. En PairwiseComplete la matrice peut ne pas être semi-définie positive.
+    CorrelationMatrix correlation(std::size_t minOverlap = 20) const;
+
+    // Covariance, corrélation, moyennes et sigmas d'un seul passage X'X (Intersection
+    // seulement : invalid_argument sinon)
+    CovarianceResult covariance(const CovarianceOptions& options = {}) const;
+
+private:
+    std::vector<std::string> labels_;
+    std::vector<std::int64_t> timestamps_;
+    std::vector<double> values_;   // ligne par ligne
+    MissingReturns missing_ = MissingReturns::Intersection;
+};
+
+#endif
@@ -1,20 +1,82 @@
 #include "Asset.hpp"
+#include <atomic>
+#include <mutex>
 #include <stdexcept>
 #include <utility>
 
-Asset::Asset(std::string name, double price, double expected_return, double volatility)
-    : name_(std::move(name)), price_(price), mu_(expected_return), sigma_(volatility) {
-    if (name_.empty()) throw std::invalid_argument("Asset: name must be non-empty.");
-    if (price_ < 0.0) throw std::invalid_argument("Asset: price must be >= 0.");
-    if (sigma_ < 0.0) throw std::invalid_argument("Asset: volatility (sigma) must be >= 0.");
+namespace {
+std::atomic<std::uint64_t> g_priceEpoch{0};
+std::mutex g_stampMutex;   // écritures partagées : époques posées puis publiées dans l'ordre
 }
 
-const std::string& Asset::name() const { return name_; }
-double Asset::price() const { return price_; }
-double Asset::expectedReturn() const { return mu_; }
-double Asset::volatility() const { return sigma_; }
+struct Asset::Record {
+    AssetId id;
+    const std::string* name;   // stocké une seule fois dans SymbolTable::global()
+    std::atomic<double> price;
+    std::atomic<double> mu;      // atomiques : AssetRegistry::upsert les réécrit
+    std::atomic<double> sigma;
+    std::atomic<std::uint64_t> epoch{0};
+
+    Record(AssetId i, const std::string* n, double p, double m, double s)
+        : id(i), name(n), price(p), mu(m), sigma(s) {}
+};
+
+Asset::Asset(std::string name, double price, double expected_return, double volatility) {
+    if (name.empty()) throw std::invalid_argument("Asset: name must be non-empty.");
+    if (price < 0.0) throw std::invalid_argument("Asset: price must be >= 0.");
+    if (volatility < 0.0) throw std::invalid_argument("Asset: volatility (sigma) must be >= 0.");
+
+    auto& symbols = SymbolTable::global();
+    const AssetId id = symbols.intern(name);
+    rec_ = std::make_shared<Record>(id, &symbols.name(id), price, expected_return, volatility);
+}
+
+// Époque propre à l'enregistrement = prochaine valeur du compteur global, posée sur
+// l'enregistrement AVANT d'être publiée : un lecteur qui voit assetPriceEpoch() == e
+// voit déjà toutes les époques <= e. Dans l'ordre inverse, Portfolio::syncHoldingsTicks
+// pourrait avancer son repère à e avant que l'actif ne porte e, et perdre le tick.
+void Asset::stamp() {
+    std::lock_guard<std::mutex> lock(g_stampMutex);
+    const std::uint64_t e = g_priceEpoch.load(std::memory_order_relaxed) + 1;
+    rec_->epoch.store(e, std::memory_order_release);
+    g_priceEpoch.store(e, std::memory_order_release);
+}
+
+std::uint64_t Asset::priceEpoch() const { return rec_->epoch.load(std::memory_order_acquire); }
+
+const std::string& Asset::name() const { return *rec_->name; }
+AssetId Asset::id() const { return rec_->id; }
+double Asset::price() const { return rec_->price.load(std::memory_order_relaxed); }
+double Asset::expectedReturn() const { return rec_->mu.load(std::memory_order_relaxed); }
+double Asset::volatility() const { return rec_->sigma.load(std::memory_order_relaxed); }
+
+void Asset::setSharedPrice(double price) {
+    if (price < 0.0) throw std::invalid_argument("Asset::setSharedPrice: price must be >= 0.");
+    rec_->price.store(price, std::memory_order_relaxed);
+    stamp();
+}
+
+void Asset::updateShared(double price, double expected_return, double volatility) {
+    if (price < 0.0) throw std::invalid_argument("Asset::updateShared: price must be >= 0.");
+    if (volatility < 0.0) throw std::invalid_argument("Asset::updateShared: volatility (sigma) must be >= 0.");
+    rec_->mu.store(expected_return, std::memory_order_relaxed);
+    rec_->sigma.store(volatility, std::memory_order_relaxed);
+    rec_->price.store(price, std::memory_order_relaxed);
+    stamp();
+}
+
+Asset Asset::detached(double price) const {
+    if (price < 0.0) throw std::invalid_argument("Asset::detached: price must be >= 0.");
+    Asset out = *this;
+    out.rec_ = std::make_shared<Record>(rec_->id, rec_->name, price, expectedReturn(), volatility());
+    return out;
+}
 
 void Asset::setPrice(double price) {
     if (price < 0.0) throw std::invalid_argument("Asset::setPrice: price must be >= 0.");
-    price_ = price;
+    // toujours un nouvel enregistrement : use_count() == 1 ne prouve pas qu'aucun
+    // autre thread n'est en train de copier la poignée
+    *this = detached(price);
 }
+
+std::uint64_t assetPriceEpoch() { return g_priceEpoch.load(std::memory_order_acquire); }
@@ -1,24 +1,51 @@
 #ifndef ASSET_HPP
 #define ASSET_HPP
 
+#include "SymbolTable.hpp"
+#include <cstdint>
+#include <memory>
 #include <string>
 
+// ATTENTION : un Asset est une POIGNÉE sur un enregistrement partagé, pas une valeur.
+// Copier un Asset (Asset b = a, Position, operator+, AssetRegistry) ne copie ni le
+// nom ni les paramètres : a et b désignent le même enregistrement.
+//   - setPrice détache : Asset b = a; b.setPrice(x) donne à b son propre enregistrement ;
+//   - setSharedPrice / updateShared écrivent dans l'enregistrement commun : vus par
+//     toutes les copies et tous les portefeuilles qui détiennent l'actif (ticks de marché).
 class Asset {
 private:
-    std::string name_;
-    double price_;
-    double mu_;
-    double sigma_;
+    struct Record;
+    std::shared_ptr<Record> rec_;
+
+    void stamp();
 
 public:
     Asset(std::string name, double price, double expected_return, double volatility);
 
     const std::string& name() const;
+    AssetId id() const;
     double price() const;
     double expectedReturn() const;
     double volatility() const;
 
+    // prix propre à cette poignée : détachement sur un nouvel enregistrement (sans
+    // toucher assetPriceEpoch()), les autres copies gardent l'ancien
     void setPrice(double price);
+    // tick partagé : une seule écriture vue par toutes les copies
+    void setSharedPrice(double price);
+    // nouveau fetch : prix, mu et sigma écrits dans l'enregistrement partagé (vus par toutes les copies)
+    void updateShared(double price, double expected_return, double volatility);
+
+    // copie indépendante (même nom/paramètres, nouveau prix) : les autres détenteurs ne la voient pas
+    Asset detached(double price) const;
+    bool sharesRecordWith(const Asset& other) const { return rec_ == other.rec_; }
+    // valeur de assetPriceEpoch() à la dernière écriture partagée ; 0 si aucune
+    std::uint64_t priceEpoch() const;
 };
 
+// Compteur global incrémenté à chaque écriture partagée (setSharedPrice, updateShared). Raccourci
+// O(1) des caches (snapshot, mode risk-tracked) : s'il n'a pas bougé, aucun prix n'a
+// changé ; sinon Asset::priceEpoch() dit quels actifs ont été touchés.
+std::uint64_t assetPriceEpoch();
+
 #endif
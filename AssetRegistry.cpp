@@ -0,0 +1,72 @@
+#include "AssetRegistry.hpp"
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+
+AssetRegistry& AssetRegistry::global() {
+    static AssetRegistry registry;
+    return registry;
+}
+
+Asset AssetRegistry::registerAsset(const std::string& name, double price, double expected_return, double volatility) {
+    Asset fresh(name, price, expected_return, volatility);
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = assets_.find(fresh.id());
+    if (it == assets_.end()) {
+        assets_.emplace(fresh.id(), fresh);
+        return fresh;
+    }
+
+    const Asset& existing = it->second;
+    const double eps = 1e-12;
+    if (std::fabs(existing.expectedReturn() - expected_return) > eps ||
+        std::fabs(existing.volatility() - volatility) > eps) {
+        throw std::invalid_argument("AssetRegistry::registerAsset: asset parameters mismatch for same name (mu/sigma).");
+    }
+    return existing;
+}
+
+Asset AssetRegistry::upsert(const Asset& a) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = assets_.find(a.id());
+    if (it == assets_.end()) {
+        assets_.emplace(a.id(), a);
+        return a;
+    }
+    if (!it->second.sharesRecordWith(a)) it->second.updateShared(a.price(), a.expectedReturn(), a.volatility());
+    return it->second;
+}
+
+bool AssetRegistry::contains(const std::string& name) const {
+    const AssetId id = SymbolTable::global().find(name);
+    if (id == kInvalidAssetId) return false;
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return assets_.count(id) != 0;
+}
+
+Asset AssetRegistry::get(const std::string& name) const {
+    const AssetId id = SymbolTable::global().find(name);
+    if (id == kInvalidAssetId) throw std::out_of_range("AssetRegistry::get: asset not registered: " + name);
+    return get(id);
+}
+
+Asset AssetRegistry::get(AssetId id) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = assets_.find(id);
+    if (it == assets_.end()) throw std::out_of_range("AssetRegistry::get: asset not registered.");
+    return it->second;
+}
+
+void AssetRegistry::setPrice(const std::string& name, double price) {
+    get(name).setSharedPrice(price);
+}
+
+void AssetRegistry::setPrice(AssetId id, double price) {
+    get(id).setSharedPrice(price);
+}
+
+std::size_t AssetRegistry::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return assets_.size();
+}
@@ -0,0 +1,38 @@
+#ifndef ASSET_REGISTRY_HPP
+#define ASSET_REGISTRY_HPP
+
+#include "Asset.hpp"
+#include <cstddef>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+// Registre des actifs du processus : une poignée Asset par ticker, partagée par
+// toutes les positions qui la reçoivent. Un tick de marché (setPrice, via
+// Asset::setSharedPrice) est une seule écriture vue par tous les portefeuilles
+// qui détiennent l'actif.
+class AssetRegistry {
+private:
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<AssetId, Asset> assets_;
+
+public:
+    static AssetRegistry& global();
+
+    // Renvoie la poignée existante (mu/sigma doivent concorder) ou en crée une
+    Asset registerAsset(const std::string& name, double price, double expected_return, double volatility);
+    // Enregistre a tel quel (poignée partagée) ; si le ticker existe déjà, pousse
+    // prix, mu et sigma de a (fetch plus récent) dans l'enregistrement existant et le renvoie
+    Asset upsert(const Asset& a);
+
+    bool contains(const std::string& name) const;
+    Asset get(const std::string& name) const;   // out_of_range si absent
+    Asset get(AssetId id) const;
+
+    void setPrice(const std::string& name, double price);
+    void setPrice(AssetId id, double price);
+
+    std::size_t size() const;
+};
+
+#endif
@@ -0,0 +1,120 @@
+#include "ChartJson.hpp"
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+const char* skipSpace(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) ++p;
+    return p;
+}
+
+// fin d'une chaîne ouverte juste avant p (guillemet non échappé), end si absente
+const char* stringEnd(const char* p, const char* end) {
+    while (p < end) {
+        const char* q = static_cast<const char*>(std::memchr(p, '"', end - p));
+        if (!q) return end;
+        const char* b = q;
+        while (b > p && b[-1] == '\\') --b;
+        if ((q - b) % 2 == 0) return q;
+        p = q + 1;
+    }
+    return end;
+}
+
+bool readValue(const char*& p, const char* end, std::int64_t& out) {
+    const auto r = std::from_chars(p, end, out);
+    if (r.ec == std::errc() && (r.ptr == end || (*r.ptr != '.' && *r.ptr != 'e' && *r.ptr != 'E'))) {
+        p = r.ptr;
+        return true;
+    }
+    double d = 0.0;   // horodatage écrit en flottant
+    const auto rd = std::from_chars(p, end, d);
+    if (rd.ec != std::errc()) return false;
+    out = static_cast<std::int64_t>(d);
+    p = rd.ptr;
+    return true;
+}
+
+bool readValue(const char*& p, const char* end, double& out) {
+    const auto r = std::from_chars(p, end, out);
+    if (r.ec != std::errc()) return false;
+    p = r.ptr;
+    return true;
+}
+
+// "[v, null, v, ...]" à partir de p (sur '['). false si le tableau ne contient pas des
+// nombres (ex. "adjclose":[{...}]) : la clé imbriquée sera trouvée plus loin.
+template <typename T>
+bool parseNumberArray(const char*& p, const char* end, std::vector<T>& out, const char* name) {
+    const char* q = skipSpace(p + 1, end);
+    if (q < end && (*q == '{' || *q == '[')) return false;
+
+    out.clear();
+    const auto malformed = [name] {
+        return std::runtime_error(std::string("Yahoo JSON: malformed ") + name + " array.");
+    };
+    if (q < end && *q == ']') {
+        p = q + 1;
+        return true;
+    }
+    while (true) {
+        if (q >= end) throw malformed();
+        if (end - q >= 4 && std::memcmp(q, "null", 4) == 0) {
+            q += 4;
+            out.push_back(std::numeric_limits<T>::has_quiet_NaN ? std::numeric_limits<T>::quiet_NaN() : T());
+        } else {
+            T v{};
+            if (!readValue(q, end, v)) throw malformed();
+            out.push_back(v);
+        }
+        q = skipSpace(q, end);
+        if (q >= end) throw malformed();
+        if (*q == ']') break;
+        if (*q != ',') throw malformed();
+        q = skipSpace(q + 1, end);
+    }
+    p = q + 1;
+    return true;
+}
+
+} // namespace
+
+ChartSeries parseChartJson(std::string_view json) {
+    ChartSeries out;
+    bool hasAdj = false;
+    bool hasVolume = false;
+
+    const char* p = json.data();
+    const char* end = p + json.size();
+    while (p < end) {
+        const char* open = static_cast<const char*>(std::memchr(p, '"', end - p));
+        if (!open) break;
+        const char* close = stringEnd(open + 1, end);
+        if (close >= end) break;
+        const std::string_view key(open + 1, close - open - 1);
+        p = close + 1;
+
+        const char* q = skipSpace(p, end);
+        if (q >= end || *q != ':') continue;   // valeur chaîne, pas une clé
+        q = skipSpace(q + 1, end);
+        if (q >= end || *q != '[') continue;
+
+        if (key == "timestamp" && !out.hasTimestamps) {
+            out.hasTimestamps = parseNumberArray(q, end, out.timestamps, "timestamp");
+        } else if (key == "close" && !out.hasCloses) {
+            out.hasCloses = parseNumberArray(q, end, out.closes, "close");
+        } else if (key == "adjclose" && !hasAdj) {
+            hasAdj = parseNumberArray(q, end, out.adjCloses, "adjclose");
+        } else if (key == "volume" && !hasVolume) {
+            hasVolume = parseNumberArray(q, end, out.volumes, "volume");
+        } else {
+            continue;
+        }
+        p = q;
+    }
+    return out;
+}
@@ -0,0 +1,24 @@
+#ifndef CHART_JSON_HPP
+#define CHART_JSON_HPP
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Colonnes d'une réponse chart Yahoo, alignées sur timestamps. Les null gardent
+// leur place (NaN) ; un tableau absent de la réponse reste vide.
+struct ChartSeries {
+    std::vector<std::int64_t> timestamps;
+    std::vector<double> closes;
+    std::vector<double> adjCloses;
+    std::vector<double> volumes;
+    bool hasTimestamps = false;   // "timestamp" présent (Yahoo l'omet quand il n'y a aucune barre)
+    bool hasCloses = false;
+};
+
+// Une seule passe sur la réponse, sans copie : memchr saute d'une clé à l'autre et
+// les nombres sont lus en place par std::from_chars (indépendant de la locale).
+// Seule la première occurrence de chaque clé compte. runtime_error si un tableau est mal formé.
+ChartSeries parseChartJson(std::string_view json);
+
+#endif
@@ -0,0 +1,145 @@
+#include "CorrelationMatrix.hpp"
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+SymmetricMatrix::SymmetricMatrix(std::size_t n, double fill)
+    : n_(n), data_(n * (n + 1) / 2, fill) {}
+
+double SymmetricMatrix::at(std::size_t i, std::size_t j) const {
+    if (i >= n_ || j >= n_) throw std::out_of_range("SymmetricMatrix::at: index out of range.");
+    return data_[index(i, j)];
+}
+
+void SymmetricMatrix::set(std::size_t i, std::size_t j, double value) {
+    if (i >= n_ || j >= n_) throw std::out_of_range("SymmetricMatrix::set: index out of range.");
+    data_[index(i, j)] = value;
+}
+
+void SymmetricMatrix::setLabels(std::vector<std::string> labels) {
+    if (!labels.empty() && labels.size() != n_) {
+        throw std::invalid_argument("SymmetricMatrix::setLabels: label count must match matrix size.");
+    }
+    labels_ = std::move(labels);
+}
+
+std::vector<std::vector<double>> SymmetricMatrix::toRows() const {
+    std::vector<std::vector<double>> rows(n_, std::vector<double>(n_, 0.0));
+    for (std::size_t i = 0; i < n_; ++i) {
+        const double* r = row(i);
+        for (std::size_t j = i; j < n_; ++j) {
+            rows[i][j] = r[j - i];
+            rows[j][i] = r[j - i];
+        }
+    }
+    return rows;
+}
+
+CorrelationMatrix::CorrelationMatrix(std::size_t n) : SymmetricMatrix(n, 0.0) {
+    for (std::size_t i = 0; i < n; ++i) row(i)[0] = 1.0;
+}
+
+CorrelationMatrix::CorrelationMatrix(std::vector<std::string> labels) : CorrelationMatrix(labels.size()) {
+    labels_ = std::move(labels);
+}
+
+CorrelationMatrix CorrelationMatrix::fromRows(const std::vector<std::vector<double>>& rows,
+                                              std::vector<std::string> labels) {
+    const std::size_t n = rows.size();
+    for (const auto& r : rows) {
+        if (r.size() != n) throw std::invalid_argument("CorrelationMatrix::fromRows: matrix must be square.");
+    }
+
+    const double epsSym = 1e-10;
+    CorrelationMatrix out;
+    out.n_ = n;
+    out.data_.assign(n * (n + 1) / 2, 0.0);
+    for (std::size_t i = 0; i < n; ++i) {
+        double* dst = out.row(i);
+        for (std::size_t j = i; j < n; ++j) {
+            if (std::fabs(rows[i][j] - rows[j][i]) > epsSym) {
+                throw std::invalid_argument("CorrelationMatrix::fromRows: matrix must be symmetric.");
+            }
+            dst[j - i] = rows[i][j];
+        }
+    }
+    out.setLabels(std::move(labels));
+    return out;
+}
+
+CovarianceMatrix::CovarianceMatrix(std::size_t n) : SymmetricMatrix(n, 0.0) {}
+
+CovarianceMatrix CovarianceMatrix::fromCorrelation(const CorrelationMatrix& corr, const std::vector<double>& sigma) {
+    const std::size_t n = corr.size();
+    if (sigma.size() != n) throw std::invalid_argument("CovarianceMatrix::fromCorrelation: sigma size mismatch.");
+
+    CovarianceMatrix out(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const double* src = corr.row(i);
+        double* dst = out.row(i);
+        for (std::size_t j = i; j < n; ++j) dst[j - i] = src[j - i] * sigma[i] * sigma[j];
+    }
+    out.setLabels(corr.labels());
+    return out;
+}
+
+void validateCorrelationEntries(const CorrelationMatrix& corr, const char* context) {
+    const std::string prefix = std::string(context) + ": ";
+    const std::size_t n = corr.size();
+    const double epsDiag = 1e-10;
+    for (std::size_t i = 0; i < n; ++i) {
+        const double* row = corr.row(i);
+        if (std::fabs(row[0] - 1.0) > epsDiag) {
+            throw std::invalid_argument(prefix + "correlation matrix diagonal must be 1.");
+        }
+        for (std::size_t k = 1; k < n - i; ++k) {
+            if (row[k] < -1.0 || row[k] > 1.0) {
+                throw std::invalid_argument(prefix + "correlation must be in [-1, 1].");
+            }
+        }
+    }
+}
+
+// Cholesky LDL' sur copie dense : pivot < -tol => pas semi-définie positive
+static bool isPositiveSemiDefinite(const CorrelationMatrix& corr) {
+    const std::size_t n = corr.size();
+    const double tol = 1e-10;
+    std::vector<double> a(n * n);
+    for (std::size_t i = 0; i < n; ++i)
+        for (std::size_t j = 0; j < n; ++j) a[i * n + j] = corr(i, j);
+
+    std::vector<double> d(n, 0.0);
+    for (std::size_t j = 0; j < n; ++j) {
+        double djj = a[j * n + j];
+        for (std::size_t k = 0; k < j; ++k) djj -= a[j * n + k] * a[j * n + k] * d[k];
+        if (djj < -tol) return false;
+        d[j] = djj;
+        for (std::size_t i = j + 1; i < n; ++i) {
+            double lij = a[i * n + j];
+            for (std::size_t k = 0; k < j; ++k) lij -= a[i * n + k] * a[j * n + k] * d[k];
+            // pivot nul (colonnes colinéaires) : la ligne doit l'être aussi
+            if (djj <= tol) {
+                if (std::fabs(lij) > 1e-8) return false;
+                a[i * n + j] = 0.0;
+            } else {
+                a[i * n + j] = lij / djj;
+            }
+        }
+    }
+    return true;
+}
+
+ValidatedCorrelation::ValidatedCorrelation(CorrelationMatrix corr, bool checkPSD) {
+    validateCorrelationEntries(corr, "ValidatedCorrelation");
+    if (checkPSD && !isPositiveSemiDefinite(corr)) {
+        throw std::invalid_argument("ValidatedCorrelation: correlation matrix must be positive semi-definite.");
+    }
+
+    psdChecked_ = checkPSD;
+    matrix_ = std::make_shared<const CorrelationMatrix>(std::move(corr));
+}
+
+const CorrelationMatrix& ValidatedCorrelation::matrix() const {
+    static const CorrelationMatrix empty;
+    return matrix_ ? *matrix_ : empty;
+}
@@ -0,0 +1,96 @@
+#ifndef CORRELATION_MATRIX_HPP
+#define CORRELATION_MATRIX_HPP
+
+#include "AlignedAllocator.hpp"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Matrice symétrique n x n stockée en triangle supérieur compacté, ligne par ligne :
+// la ligne i contient (i,i), (i,i+1), ..., (i,n-1) de façon contiguë.
+// n(n+1)/2 doubles dans un seul buffer aligné sur 64 octets, labels attachés.
+class SymmetricMatrix {
+protected:
+    std::size_t n_ = 0;
+    AlignedDoubles data_;
+    std::vector<std::string> labels_;
+
+    static std::size_t rowOffset(std::size_t i, std::size_t n) { return i * (2 * n - i + 1) / 2; }
+    std::size_t index(std::size_t i, std::size_t j) const {
+        if (i > j) { const std::size_t t = i; i = j; j = t; }
+        return rowOffset(i, n_) + (j - i);
+    }
+
+public:
+    SymmetricMatrix() = default;
+    explicit SymmetricMatrix(std::size_t n, double fill = 0.0);
+
+    std::size_t size() const { return n_; }
+    bool empty() const { return n_ == 0; }
+
+    double operator()(std::size_t i, std::size_t j) const { return data_[index(i, j)]; }
+    double at(std::size_t i, std::size_t j) const;
+    void set(std::size_t i, std::size_t j, double value);
+
+    // ligne compactée : pointe sur (i,i), longueur n - i
+    const double* row(std::size_t i) const { return data_.data() + rowOffset(i, n_); }
+    double* row(std::size_t i) { return data_.data() + rowOffset(i, n_); }
+
+    const double* data() const { return data_.data(); }
+    std::size_t packedSize() const { return data_.size(); }
+
+    const std::vector<std::string>& labels() const { return labels_; }
+    void setLabels(std::vector<std::string> labels);
+
+    std::vector<std::vector<double>> toRows() const;
+};
+
+class CorrelationMatrix : public SymmetricMatrix {
+public:
+    CorrelationMatrix() = default;
+    // identité n x n
+    explicit CorrelationMatrix(std::size_t n);
+    // identité dimensionnée par les labels
+    explicit CorrelationMatrix(std::vector<std::string> labels);
+
+    // Compacte une matrice pleine (carrée, symétrique) ; lève invalid_argument sinon
+    static CorrelationMatrix fromRows(const std::vector<std::vector<double>>& rows,
+                                      std::vector<std::string> labels = {});
+};
+
+class CovarianceMatrix : public SymmetricMatrix {
+public:
+    CovarianceMatrix() = default;
+    explicit CovarianceMatrix(std::size_t n);
+
+    // cov(i,j) = corr(i,j) * sigma_i * sigma_j
+    static CovarianceMatrix fromCorrelation(const CorrelationMatrix& corr, const std::vector<double>& sigma);
+};
+
+// Contrôle du contenu : diagonale = 1, coefficients dans [-1, 1].
+// Lève invalid_argument (messages préfixés par context).
+void validateCorrelationEntries(const CorrelationMatrix& corr, const char* context);
+
+// Poignée immuable sur une matrice de corrélation validée une seule fois, à la construction
+// (et optionnellement testée semi-définie positive). Les fonctions de risque qui la
+// reçoivent ne refont pas le balayage O(n^2) ; les copies partagent la matrice.
+class ValidatedCorrelation {
+private:
+    std::shared_ptr<const CorrelationMatrix> matrix_;
+    bool psdChecked_ = false;
+
+public:
+    ValidatedCorrelation() = default;
+    explicit ValidatedCorrelation(CorrelationMatrix corr, bool checkPSD = false);
+
+    bool empty() const { return !matrix_ || matrix_->empty(); }
+    std::size_t size() const { return matrix_ ? matrix_->size() : 0; }
+    const CorrelationMatrix& matrix() const;
+    const std::shared_ptr<const CorrelationMatrix>& shared() const { return matrix_; }
+    const std::vector<std::string>& labels() const { return matrix().labels(); }
+
+    bool psdChecked() const { return psdChecked_; }
+};
+
+#endif
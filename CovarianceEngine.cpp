@@ -0,0 +1,122 @@
+#include "CovarianceEngine.hpp"
+#include "AlignedAllocator.hpp"
+#include "RiskKernels.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+static std::size_t roundUp(std::size_t x, std::size_t m) { return (x + m - 1) / m * m; }
+
+CovarianceResult computeCovariance(const double* rows, std::size_t T, std::size_t n,
+                                   std::vector<std::string> labels, const CovarianceOptions& options) {
+    if (T < 2) throw std::invalid_argument("computeCovariance: need at least 2 observations.");
+    if (!labels.empty() && labels.size() != n) {
+        throw std::invalid_argument("computeCovariance: label count must match series count.");
+    }
+
+    CovarianceResult out;
+    out.mean.assign(n, 0.0);
+    out.sigma.assign(n, 0.0);
+    out.covariance = CovarianceMatrix(n);
+    out.correlation = CorrelationMatrix(n);
+    if (n == 0) return out;
+
+    for (std::size_t t = 0; t < T; ++t) {
+        const double* r = rows + t * n;
+        for (std::size_t i = 0; i < n; ++i) out.mean[i] += r[i];
+    }
+    for (double& m : out.mean) m /= (double)T;
+
+    // X centrée par colonnes ; colonnes et dates complétées par des zéros (tuiles pleines)
+    const std::size_t nPad = roundUp(n, 4);
+    const std::size_t stride = roundUp(T, 8);
+    // colonne strictement constante : centrée à zéro exactement (sinon résidu d'arrondi de la moyenne)
+    std::vector<char> constant(n, 1);
+    AlignedDoubles x(nPad * stride, 0.0);
+    for (std::size_t t = 0; t < T; ++t) {
+        const double* r = rows + t * n;
+        for (std::size_t i = 0; i < n; ++i) {
+            x[i * stride + t] = r[i] - out.mean[i];
+            if (r[i] != rows[i]) constant[i] = 0;
+        }
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        if (constant[i]) std::fill(x.begin() + (long long)(i * stride), x.begin() + (long long)(i * stride + T), 0.0);
+    }
+
+    const std::size_t block = std::max<std::size_t>(4, roundUp(options.blockColumns, 4));
+    const std::size_t chunk = std::max<std::size_t>(8, roundUp(options.blockRows, 8));
+    const std::size_t blocks = (nPad + block - 1) / block;
+    std::vector<std::pair<std::size_t, std::size_t>> tasks;
+    tasks.reserve(blocks * (blocks + 1) / 2);
+    for (std::size_t bi = 0; bi < blocks; ++bi)
+        for (std::size_t bj = bi; bj < blocks; ++bj) tasks.emplace_back(bi, bj);
+
+    const double scale = 1.0 / (double)(T - 1);
+    std::atomic<std::size_t> next{0};
+    auto worker = [&] {
+        std::vector<double> acc(block * block);
+        for (std::size_t task = next.fetch_add(1); task < tasks.size(); task = next.fetch_add(1)) {
+            const std::size_t i0 = tasks[task].first * block;
+            const std::size_t j0 = tasks[task].second * block;
+            const std::size_t iEnd = std::min(nPad, i0 + block);
+            const std::size_t jEnd = std::min(nPad, j0 + block);
+            std::fill(acc.begin(), acc.end(), 0.0);
+
+            // passes sur des tranches de dates : les deux blocs restent en cache
+            for (std::size_t k0 = 0; k0 < stride; k0 += chunk) {
+                const std::size_t len = std::min(chunk, stride - k0);
+                for (std::size_t i = i0; i < iEnd; i += 4) {
+                    const double* a[4];
+                    for (int r = 0; r < 4; ++r) a[r] = x.data() + (i + r) * stride + k0;
+                    // bloc diagonal : tuiles entièrement sous la diagonale sautées
+                    const std::size_t jStart = j0 == i0 ? i : j0;
+                    for (std::size_t j = jStart; j < jEnd; j += 2) {
+                        const double* b[2] = {x.data() + j * stride + k0, x.data() + (j + 1) * stride + k0};
+                        double tile[8];
+                        gramTile4x2(a, b, len, tile);
+                        for (int r = 0; r < 4; ++r) {
+                            double* dst = acc.data() + (i - i0 + r) * block + (j - j0);
+                            dst[0] += tile[2 * r];
+                            dst[1] += tile[2 * r + 1];
+                        }
+                    }
+                }
+            }
+
+            for (std::size_t i = i0; i < std::min(n, iEnd); ++i) {
+                double* dst = out.covariance.row(i);
+                for (std::size_t j = std::max(i, j0); j < std::min(n, jEnd); ++j) {
+                    dst[j - i] = acc[(i - i0) * block + (j - j0)] * scale;
+                }
+            }
+        }
+    };
+
+    std::size_t threads = options.threads ? options.threads : std::thread::hardware_concurrency();
+    threads = std::min(tasks.size(), std::max<std::size_t>(1, threads));
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (std::size_t t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& th : pool) th.join();
+
+    for (std::size_t i = 0; i < n; ++i) out.sigma[i] = std::sqrt(std::max(0.0, out.covariance.row(i)[0]));
+    for (std::size_t i = 0; i < n; ++i) {
+        const double* src = out.covariance.row(i);
+        double* dst = out.correlation.row(i);
+        for (std::size_t j = i + 1; j < n; ++j) {
+            if (out.sigma[i] <= 0.0 || out.sigma[j] <= 0.0) continue;   // série quasi constante
+            double c = src[j - i] / (out.sigma[i] * out.sigma[j]);
+            if (c < -1.0) c = -1.0;
+            if (c > 1.0) c = 1.0;
+            dst[j - i] = c;
+        }
+    }
+    out.covariance.setLabels(labels);
+    out.correlation.setLabels(std::move(labels));
+    return out;
+}
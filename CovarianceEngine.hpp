@@ -0,0 +1,30 @@
+#ifndef COVARIANCE_ENGINE_HPP
+#define COVARIANCE_ENGINE_HPP
+
+#include "CorrelationMatrix.hpp"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+struct CovarianceOptions {
+    std::size_t threads = 0;          // 0 = std::thread::hardware_concurrency()
+    std::size_t blockColumns = 64;    // colonnes par bloc (arrondi à un multiple de 4)
+    std::size_t blockRows = 256;      // dates par passe sur un couple de blocs (tient en L2)
+};
+
+struct CovarianceResult {
+    CovarianceMatrix covariance;    // X'X / (T - 1), X centrée
+    CorrelationMatrix correlation;  // cov_ij / (sigma_i sigma_j), 0 pour une série constante
+    std::vector<double> mean;
+    std::vector<double> sigma;      // écart-type par période (non annualisé)
+};
+
+// Matrice de covariance de T observations de n séries (rows : T x n, ligne par ligne).
+// X est centrée une fois et stockée par colonnes ; X'X est calculé par couples de
+// blocs (triangle supérieur seulement) répartis entre threads, chaque bloc avec le
+// noyau SIMD gramTile4x2. invalid_argument si T < 2 ou labels de mauvaise taille.
+CovarianceResult computeCovariance(const double* rows, std::size_t T, std::size_t n,
+                                   std::vector<std::string> labels = {},
+                                   const CovarianceOptions& options = {});
+
+#endif
@@ -0,0 +1,145 @@
+#include "HistoryCache.hpp"
+#include <exception>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+std::int64_t historyRangeSeconds(const std::string& range) {
+    const std::int64_t day = 86400;
+    if (range == "1d") return day;
+    if (range == "5d") return 5 * day;
+    if (range == "1mo") return 31 * day;
+    if (range == "3mo") return 92 * day;
+    if (range == "6mo") return 183 * day;
+    if (range == "1y") return 365 * day;
+    if (range == "2y") return 2 * 365 * day;
+    if (range == "5y") return 5 * 365 * day;
+    if (range == "10y") return 10 * 365 * day;
+    return 0;
+}
+
+static std::string cacheKey(const HistoryKey& key) {
+    return key.ticker + '\x1f' + key.range + '\x1f' + key.interval;
+}
+
+// empreinte approximative : structure + capacités des buffers
+static std::size_t approximateBytes(const PriceHistory& h) {
+    return sizeof(PriceHistory) + h.ticker.capacity() +
+           h.timestamps.capacity() * sizeof(std::int64_t) +
+           h.closes.capacity() * sizeof(double) +
+           h.logReturns.capacity() * sizeof(double) +
+           h.returnTimestamps.capacity() * sizeof(std::int64_t);
+}
+
+HistoryCache::HistoryCache() : HistoryCache(Options()) {}
+
+HistoryCache::HistoryCache(Options options) : options_(std::move(options)) {}
+
+HistoryCache::Clock::time_point HistoryCache::now() const {
+    return options_.now ? options_.now() : Clock::now();
+}
+
+void HistoryCache::eraseLocked(std::list<Entry>::iterator it) {
+    stats_.bytes -= it->bytes;
+    index_.erase(it->key);
+    lru_.erase(it);
+}
+
+void HistoryCache::insertLocked(const std::string& k, Value value) {
+    auto it = index_.find(k);
+    if (it != index_.end()) eraseLocked(it->second);
+    const std::size_t bytes = approximateBytes(*value);
+    if (bytes > options_.maxBytes) return;
+    lru_.push_front(Entry{k, std::move(value), now() + options_.ttl, bytes});
+    index_[k] = lru_.begin();
+    stats_.bytes += bytes;
+    while (stats_.bytes > options_.maxBytes) {
+        eraseLocked(std::prev(lru_.end()));
+        ++stats_.evictions;
+    }
+}
+
+std::shared_ptr<const PriceHistory> HistoryCache::get(const HistoryKey& key, const Fetcher& fetch,
+                                                      Clock::duration waitTimeout) {
+    const std::string k = cacheKey(key);
+    std::promise<Value> promise;
+    std::uint64_t generation = 0;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto it = index_.find(k);
+        if (it != index_.end()) {
+            if (now() < it->second->expires) {
+                lru_.splice(lru_.begin(), lru_, it->second);
+                ++stats_.hits;
+                return it->second->value;
+            }
+            eraseLocked(it->second);
+            ++stats_.expirations;
+        }
+
+        auto pending = inflight_.find(k);
+        if (pending != inflight_.end()) {
+            std::shared_future<Value> wait = pending->second;
+            ++stats_.coalesced;
+            lock.unlock();
+            if (waitTimeout > Clock::duration::zero() && wait.wait_for(waitTimeout) != std::future_status::ready) {
+                throw std::runtime_error("HistoryCache::get: timed out waiting for the in-flight fetch.");
+            }
+            return wait.get();
+        }
+
+        ++stats_.misses;
+        inflight_.emplace(k, promise.get_future().share());
+        generation = generation_;
+    }
+
+    Value value;
+    try {
+        value = std::make_shared<const PriceHistory>(fetch());
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (generation == generation_) inflight_.erase(k);
+        }
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (generation == generation_) {
+            inflight_.erase(k);
+            insertLocked(k, value);
+        }
+    }
+    promise.set_value(value);
+    return value;
+}
+
+void HistoryCache::put(const HistoryKey& key, std::shared_ptr<const PriceHistory> history) {
+    if (!history) throw std::invalid_argument("HistoryCache::put: history must be non-null.");
+    std::lock_guard<std::mutex> lock(mutex_);
+    insertLocked(cacheKey(key), std::move(history));
+}
+
+void HistoryCache::invalidate(const HistoryKey& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(cacheKey(key));
+    if (it != index_.end()) eraseLocked(it->second);
+}
+
+void HistoryCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    index_.clear();
+    inflight_.clear();   // les demandeurs déjà rattachés gardent leur shared_future
+    ++generation_;
+    stats_.bytes = 0;
+}
+
+HistoryCache::Stats HistoryCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats s = stats_;
+    s.entries = lru_.size();
+    return s;
+}
@@ -0,0 +1,88 @@
+#ifndef HISTORY_CACHE_HPP
+#define HISTORY_CACHE_HPP
+
+#include "PriceHistory.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+struct HistoryKey {
+    std::string ticker;
+    std::string range = "1y";
+    std::string interval = "1d";
+};
+
+// Durée couverte par un range Yahoo ("1y" => 365 jours) ; 0 (pas de fenêtre) pour ytd/max/inconnu
+std::int64_t historyRangeSeconds(const std::string& range);
+
+// Cache LRU borné (octets estimés) d'historiques, avec TTL et "singleflight" :
+// les demandes simultanées d'une même clé attendent l'unique fetch en cours.
+// Un fetch en échec n'est pas mis en cache ; l'exception est relancée à tous les demandeurs.
+class HistoryCache {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Fetcher = std::function<PriceHistory()>;
+
+    struct Options {
+        std::size_t maxBytes = std::size_t(64) << 20;
+        Clock::duration ttl = std::chrono::minutes(15);
+        std::function<Clock::time_point()> now;   // horloge injectable (tests) ; Clock::now si vide
+    };
+
+    struct Stats {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;        // fetchs lancés
+        std::uint64_t coalesced = 0;     // demandes rattachées à un fetch en cours
+        std::uint64_t evictions = 0;     // plafond mémoire
+        std::uint64_t expirations = 0;   // TTL
+        std::size_t entries = 0;
+        std::size_t bytes = 0;
+    };
+
+    HistoryCache();
+    explicit HistoryCache(Options options);
+
+    HistoryCache(const HistoryCache&) = delete;
+    HistoryCache& operator=(const HistoryCache&) = delete;
+
+    // Entrée valide, sinon fetch (ou attente du fetch en cours pour cette clé, au plus
+    // waitTimeout si > 0 : runtime_error au-delà, le fetch en cours continue)
+    std::shared_ptr<const PriceHistory> get(const HistoryKey& key, const Fetcher& fetch,
+                                            Clock::duration waitTimeout = Clock::duration::zero());
+
+    // Remplace l'entrée (TTL repart de zéro), ex. après ajout des dernières barres
+    void put(const HistoryKey& key, std::shared_ptr<const PriceHistory> history);
+    void invalidate(const HistoryKey& key);
+    void clear();   // les fetchs en cours au moment du clear ne sont pas insérés
+    Stats stats() const;
+
+private:
+    using Value = std::shared_ptr<const PriceHistory>;
+    struct Entry {
+        std::string key;
+        Value value;
+        Clock::time_point expires;
+        std::size_t bytes;
+    };
+
+    Options options_;
+    mutable std::mutex mutex_;
+    std::list<Entry> lru_;   // plus récent en tête
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    std::unordered_map<std::string, std::shared_future<Value>> inflight_;
+    std::uint64_t generation_ = 0;
+    Stats stats_;
+
+    Clock::time_point now() const;
+    void eraseLocked(std::list<Entry>::iterator it);
+    void insertLocked(const std::string& k, Value value);
+};
+
+#endif
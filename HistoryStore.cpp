@@ -0,0 +1,205 @@
+#include "HistoryStore.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char kMagic[8] = {'P', 'X', 'H', 'I', 'S', 'T', '\0', '\0'};
+constexpr std::uint32_t kByteOrderTag = 0x01020304u;
+
+struct StoreHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint64_t count;
+    std::int64_t fetchedAt;
+    std::int64_t reserved[4];
+};
+static_assert(sizeof(StoreHeader) == 64, "StoreHeader must stay 64 bytes (column alignment)");
+
+// caractères sûrs pour un nom de fichier ; le reste en %XX (^GSPC, EURUSD=X, ...)
+void appendEscaped(std::string& out, const std::string& s) {
+    static const char* hex = "0123456789ABCDEF";
+    for (unsigned char c : s) {
+        const bool safe = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') ||
+                          (c >= '0' && c <= '9') || c == '-' || c == '.';
+        if (safe) {
+            out += static_cast<char>(c);
+        } else {
+            out += '%';
+            out += hex[c >> 4];
+            out += hex[c & 0xF];
+        }
+    }
+}
+
+unsigned long processId() {
+#ifdef _WIN32
+    return static_cast<unsigned long>(GetCurrentProcessId());
+#else
+    return static_cast<unsigned long>(getpid());
+#endif
+}
+
+} // namespace
+
+MappedHistory::~MappedHistory() {
+#ifdef _WIN32
+    if (base_) UnmapViewOfFile(base_);
+    if (mapping_) CloseHandle(mapping_);
+#else
+    if (base_) munmap(const_cast<void*>(base_), bytes_);
+#endif
+}
+
+PriceHistory MappedHistory::toPriceHistory(const std::string& ticker) const {
+    return PriceHistory::fromCloses(ticker,
+                                    std::vector<std::int64_t>(timestamps_, timestamps_ + count_),
+                                    std::vector<double>(closes_, closes_ + count_));
+}
+
+HistoryStore::HistoryStore(std::string directory) : HistoryStore(std::move(directory), Options()) {}
+
+HistoryStore::HistoryStore(std::string directory, Options options)
+    : directory_(std::move(directory)), options_(std::move(options)) {
+    if (directory_.empty()) throw std::invalid_argument("HistoryStore: directory must be non-empty.");
+}
+
+std::int64_t HistoryStore::now() const {
+    if (options_.now) return options_.now();
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::string HistoryStore::pathFor(const HistoryKey& key) const {
+    std::string file;
+    appendEscaped(file, key.ticker);
+    file += '_';
+    appendEscaped(file, key.range);
+    file += '_';
+    appendEscaped(file, key.interval);
+    file += ".phs";
+    return (fs::path(directory_) / file).string();
+}
+
+std::unique_ptr<MappedHistory> HistoryStore::open(const HistoryKey& key) const {
+    const std::string path = pathFor(key);
+    std::unique_ptr<MappedHistory> view(new MappedHistory());
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return nullptr;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart < (long long)sizeof(StoreHeader)) {
+        CloseHandle(file);
+        return nullptr;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);   // le mapping garde le fichier ouvert
+    if (!mapping) return nullptr;
+    view->mapping_ = mapping;
+    view->bytes_ = static_cast<std::size_t>(size.QuadPart);
+    view->base_ = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view->base_) return nullptr;
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(StoreHeader)) {
+        ::close(fd);
+        return nullptr;
+    }
+    void* base = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);   // le mapping reste valide après close
+    if (base == MAP_FAILED) return nullptr;
+    view->base_ = base;
+    view->bytes_ = static_cast<std::size_t>(st.st_size);
+#endif
+
+    StoreHeader header;
+    std::memcpy(&header, view->base_, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) return nullptr;
+    if (header.version != kHistoryStoreVersion || header.byteOrder != kByteOrderTag) return nullptr;
+    const std::size_t columns = view->bytes_ - sizeof(StoreHeader);
+    if (header.count > columns / 16 || header.count * 16 != columns) return nullptr;
+
+    const unsigned char* bytes = static_cast<const unsigned char*>(view->base_);
+    view->count_ = static_cast<std::size_t>(header.count);
+    view->fetchedAt_ = header.fetchedAt;
+    view->timestamps_ = reinterpret_cast<const std::int64_t*>(bytes + sizeof(StoreHeader));
+    view->closes_ = reinterpret_cast<const double*>(bytes + sizeof(StoreHeader) + view->count_ * sizeof(std::int64_t));
+    return view;
+}
+
+std::optional<PriceHistory> HistoryStore::loadFresh(const HistoryKey& key) const {
+    const auto view = open(key);
+    if (!view) return std::nullopt;
+    if (!isFresh(*view)) return std::nullopt;
+    return view->toPriceHistory(key.ticker);
+}
+
+void HistoryStore::save(const HistoryKey& key, const PriceHistory& history) const {
+    if (history.timestamps.size() != history.closes.size()) {
+        throw std::invalid_argument("HistoryStore::save: timestamps/closes size mismatch.");
+    }
+
+    std::error_code ec;
+    fs::create_directories(directory_, ec);
+    if (ec) throw std::runtime_error("HistoryStore::save: cannot create " + directory_ + ": " + ec.message());
+
+    StoreHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kHistoryStoreVersion;
+    header.byteOrder = kByteOrderTag;
+    header.count = history.closes.size();
+    header.fetchedAt = now();
+
+    // nom temporaire unique par écriture (pid + séquence) : deux sauvegardes concurrentes,
+    // du même processus ou de deux processus sur le même répertoire, ne se mélangent pas
+    static std::atomic<std::uint64_t> sequence{0};
+    const std::string path = pathFor(key);
+    const std::string tmp = path + ".tmp" + std::to_string(processId()) + "_" + std::to_string(sequence.fetch_add(1));
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(history.timestamps.data()),
+                  static_cast<std::streamsize>(history.timestamps.size() * sizeof(std::int64_t)));
+        out.write(reinterpret_cast<const char*>(history.closes.data()),
+                  static_cast<std::streamsize>(history.closes.size() * sizeof(double)));
+        out.close();
+        if (!out) {
+            fs::remove(tmp, ec);
+            throw std::runtime_error("HistoryStore::save: cannot write " + tmp + ".");
+        }
+    }
+    fs::rename(tmp, path, ec);
+    if (ec) {
+        fs::remove(tmp, ec);
+        throw std::runtime_error("HistoryStore::save: cannot replace " + path + ".");
+    }
+}
+
+bool HistoryStore::remove(const HistoryKey& key) const {
+    std::error_code ec;
+    return fs::remove(pathFor(key), ec);
+}
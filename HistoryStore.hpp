@@ -0,0 +1,82 @@
+#ifndef HISTORY_STORE_HPP
+#define HISTORY_STORE_HPP
+
+#include "HistoryCache.hpp"
+#include "PriceHistory.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+
+// Fichier du store : en-tête fixe de 64 octets (magic, version, ordre des octets,
+// nombre de points, date du fetch) puis deux colonnes de largeur fixe,
+// int64 timestamps[n] et double closes[n], dans l'ordre natif de la machine.
+constexpr std::uint32_t kHistoryStoreVersion = 1;
+
+// Vue en lecture seule sur un fichier du store, projeté en mémoire (mmap /
+// MapViewOfFile) : les colonnes sont lues en place, sans décodage.
+class MappedHistory {
+public:
+    ~MappedHistory();
+    MappedHistory(const MappedHistory&) = delete;
+    MappedHistory& operator=(const MappedHistory&) = delete;
+
+    std::size_t size() const { return count_; }
+    const std::int64_t* timestamps() const { return timestamps_; }
+    const double* closes() const { return closes_; }
+    std::int64_t fetchedAt() const { return fetchedAt_; }   // secondes Unix
+
+    // Copie des colonnes puis rendements/statistiques (PriceHistory::fromCloses)
+    PriceHistory toPriceHistory(const std::string& ticker) const;
+
+private:
+    friend class HistoryStore;
+    MappedHistory() = default;
+
+    const void* base_ = nullptr;
+    std::size_t bytes_ = 0;
+    void* mapping_ = nullptr;   // HANDLE de mapping sous Windows
+    std::size_t count_ = 0;
+    std::int64_t fetchedAt_ = 0;
+    const std::int64_t* timestamps_ = nullptr;
+    const double* closes_ = nullptr;
+};
+
+// Store disque d'historiques, un fichier par (ticker, range, interval) dans
+// directory. Les écritures passent par un fichier temporaire renommé : un lecteur
+// voit l'ancienne ou la nouvelle version, jamais un fichier partiel.
+class HistoryStore {
+public:
+    struct Options {
+        std::int64_t maxAgeSeconds = 12 * 3600;   // au-delà, le fichier est périmé
+        std::function<std::int64_t()> now;        // secondes Unix (tests) ; system_clock si vide
+    };
+
+    explicit HistoryStore(std::string directory);
+    HistoryStore(std::string directory, Options options);
+
+    const std::string& directory() const { return directory_; }
+    std::string pathFor(const HistoryKey& key) const;
+
+    // nullptr si absent, tronqué, d'une autre version ou d'un autre ordre d'octets
+    std::unique_ptr<MappedHistory> open(const HistoryKey& key) const;
+
+    bool isFresh(const MappedHistory& view) const { return now() - view.fetchedAt() <= options_.maxAgeSeconds; }
+
+    // Historique si le fichier existe et n'est pas périmé
+    std::optional<PriceHistory> loadFresh(const HistoryKey& key) const;
+
+    // Crée le répertoire si besoin ; runtime_error en cas d'échec d'écriture
+    void save(const HistoryKey& key, const PriceHistory& history) const;
+    bool remove(const HistoryKey& key) const;
+
+private:
+    std::string directory_;
+    Options options_;
+
+    std::int64_t now() const;
+};
+
+#endif
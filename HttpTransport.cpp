@@ -0,0 +1,205 @@
+#include "HttpTransport.hpp"
+
+#include <cstdlib>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <winhttp.h>
+#else
+#include "httplib.h"
+#endif
+
+HttpEndpoint HttpEndpoint::parse(const std::string& url) {
+    HttpEndpoint ep;
+    std::string rest;
+    if (url.rfind("https://", 0) == 0) {
+        ep.tls = true;
+        ep.port = 443;
+        rest = url.substr(8);
+    } else if (url.rfind("http://", 0) == 0) {
+        ep.tls = false;
+        ep.port = 80;
+        rest = url.substr(7);
+    } else {
+        throw std::invalid_argument("HttpEndpoint::parse: URL must start with http:// or https://.");
+    }
+
+    const std::size_t slash = rest.find('/');
+    if (slash != std::string::npos) rest.erase(slash);
+    const std::size_t colon = rest.rfind(':');
+    if (colon != std::string::npos) {
+        const std::string portText = rest.substr(colon + 1);
+        char* end = nullptr;
+        const long port = std::strtol(portText.c_str(), &end, 10);
+        if (portText.empty() || *end != '\0' || port <= 0 || port > 65535) {
+            throw std::invalid_argument("HttpEndpoint::parse: invalid port.");
+        }
+        ep.port = static_cast<int>(port);
+        rest.erase(colon);
+    }
+    if (rest.empty()) throw std::invalid_argument("HttpEndpoint::parse: missing host.");
+    ep.host = rest;
+    return ep;
+}
+
+namespace {
+
+#ifdef _WIN32
+
+std::wstring toWide(const std::string& s) {
+    if (s.empty()) return L"";
+    int size_needed = MultiByteToWideChar(CP_UTF8, 0, s.c_str(), (int)s.size(), nullptr, 0);
+    std::wstring w(size_needed, 0);
+    MultiByteToWideChar(CP_UTF8, 0, s.c_str(), (int)s.size(), &w[0], size_needed);
+    return w;
+}
+
+// Une session et une connexion WinHTTP pour toute la durée de vie du transport :
+// WinHTTP réutilise les sockets (et la session TLS) d'une requête à l'autre.
+class WinHttpTransport : public HttpTransport {
+private:
+    HINTERNET session_ = nullptr;
+    HINTERNET connect_ = nullptr;
+    bool tls_;
+
+public:
+    explicit WinHttpTransport(const HttpEndpoint& ep) : tls_(ep.tls) {
+        session_ = WinHttpOpen(L"PortfolioProject/1.0",
+                               WINHTTP_ACCESS_TYPE_DEFAULT_PROXY,
+                               WINHTTP_NO_PROXY_NAME,
+                               WINHTTP_NO_PROXY_BYPASS, 0);
+        if (!session_) throw std::runtime_error("WinHttpOpen failed");
+        WinHttpSetTimeouts(session_, ep.connectTimeoutMs, ep.connectTimeoutMs, ep.readTimeoutMs, ep.readTimeoutMs);
+
+        connect_ = WinHttpConnect(session_, toWide(ep.host).c_str(), static_cast<INTERNET_PORT>(ep.port), 0);
+        if (!connect_) {
+            WinHttpCloseHandle(session_);
+            throw std::runtime_error("WinHttpConnect failed");
+        }
+    }
+
+    ~WinHttpTransport() override {
+        WinHttpCloseHandle(connect_);
+        WinHttpCloseHandle(session_);
+    }
+
+    WinHttpTransport(const WinHttpTransport&) = delete;
+    WinHttpTransport& operator=(const WinHttpTransport&) = delete;
+
+    std::string get(const std::string& path, int timeoutMs) override {
+        HINTERNET hRequest = WinHttpOpenRequest(connect_, L"GET", toWide(path).c_str(),
+                                                nullptr, WINHTTP_NO_REFERER,
+                                                WINHTTP_DEFAULT_ACCEPT_TYPES,
+                                                tls_ ? WINHTTP_FLAG_SECURE : 0);
+        if (!hRequest) throw std::runtime_error("WinHttpOpenRequest failed");
+        if (timeoutMs > 0) WinHttpSetTimeouts(hRequest, timeoutMs, timeoutMs, timeoutMs, timeoutMs);
+
+        if (!WinHttpSendRequest(hRequest, WINHTTP_NO_ADDITIONAL_HEADERS, 0, WINHTTP_NO_REQUEST_DATA, 0, 0, 0)) {
+            WinHttpCloseHandle(hRequest);
+            throw std::runtime_error("WinHttpSendRequest failed");
+        }
+        if (!WinHttpReceiveResponse(hRequest, nullptr)) {
+            WinHttpCloseHandle(hRequest);
+            throw std::runtime_error("WinHttpReceiveResponse failed");
+        }
+
+        DWORD status = 0;
+        DWORD statusSize = sizeof(status);
+        WinHttpQueryHeaders(hRequest, WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER,
+                            WINHTTP_HEADER_NAME_BY_INDEX, &status, &statusSize, WINHTTP_NO_HEADER_INDEX);
+
+        std::string response;
+        DWORD dwSize = 0;
+        do {
+            DWORD dwDownloaded = 0;
+            if (!WinHttpQueryDataAvailable(hRequest, &dwSize)) break;
+            if (dwSize == 0) break;
+
+            std::vector<char> buffer(dwSize);
+            if (!WinHttpReadData(hRequest, buffer.data(), dwSize, &dwDownloaded)) break;
+
+            response.append(buffer.data(), buffer.data() + dwDownloaded);
+        } while (dwSize > 0);
+
+        WinHttpCloseHandle(hRequest);
+
+        if (status != 200) throw std::runtime_error("HTTP GET failed with status " + std::to_string(status));
+        if (response.empty()) throw std::runtime_error("Empty HTTP response");
+        return response;
+    }
+};
+
+#else
+
+// Pool de clients httplib keep-alive : une requête emprunte un client libre (ou en
+// crée un), le rend après succès. Un client en erreur est jeté (socket douteuse).
+class HttplibTransport : public HttpTransport {
+private:
+    HttpEndpoint ep_;
+    std::string origin_;
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<httplib::Client>> idle_;
+    std::size_t maxIdle_ = 8;
+
+    std::unique_ptr<httplib::Client> acquire() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!idle_.empty()) {
+                auto c = std::move(idle_.back());
+                idle_.pop_back();
+                return c;
+            }
+        }
+        auto c = std::make_unique<httplib::Client>(origin_);
+        if (!c->is_valid()) {
+            throw std::runtime_error("HttpTransport: cannot create client for " + origin_ +
+                                     (ep_.tls ? " (HTTPS requires CPPHTTPLIB_OPENSSL_SUPPORT)." : "."));
+        }
+        c->set_keep_alive(true);
+        c->set_connection_timeout(ep_.connectTimeoutMs / 1000, (ep_.connectTimeoutMs % 1000) * 1000);
+        c->set_default_headers({{"User-Agent", "PortfolioProject/1.0"}});
+        return c;
+    }
+
+    void release(std::unique_ptr<httplib::Client> c) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (idle_.size() < maxIdle_) idle_.push_back(std::move(c));
+    }
+
+public:
+    explicit HttplibTransport(const HttpEndpoint& ep)
+        : ep_(ep), origin_((ep.tls ? "https://" : "http://") + ep.host + ":" + std::to_string(ep.port)) {}
+
+    std::string get(const std::string& path, int timeoutMs) override {
+        auto client = acquire();
+        const int readMs = timeoutMs > 0 ? timeoutMs : ep_.readTimeoutMs;
+        client->set_read_timeout(readMs / 1000, (readMs % 1000) * 1000);
+        client->set_write_timeout(readMs / 1000, (readMs % 1000) * 1000);
+        client->set_max_timeout(readMs);   // échéance totale, pas seulement par lecture
+        auto res = client->Get(path);
+        if (!res) throw std::runtime_error("HTTP GET failed: " + httplib::to_string(res.error()));
+        const int status = res->status;
+        std::string body = std::move(res->body);
+        release(std::move(client));
+        if (status != 200) throw std::runtime_error("HTTP GET failed with status " + std::to_string(status));
+        if (body.empty()) throw std::runtime_error("Empty HTTP response");
+        return body;
+    }
+};
+
+#endif
+
+} // namespace
+
+std::unique_ptr<HttpTransport> makeHttpTransport(const HttpEndpoint& endpoint) {
+#ifdef _WIN32
+    return std::make_unique<WinHttpTransport>(endpoint);
+#else
+    return std::make_unique<HttplibTransport>(endpoint);
+#endif
+}
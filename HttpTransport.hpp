@@ -0,0 +1,38 @@
+#ifndef HTTP_TRANSPORT_HPP
+#define HTTP_TRANSPORT_HPP
+
+#include <memory>
+#include <string>
+
+// Cible HTTP(S) : hôte, port, TLS et délais. Configurable pour pointer vers
+// un serveur local qui rejoue des réponses enregistrées.
+struct HttpEndpoint {
+    std::string host = "query1.finance.yahoo.com";
+    int port = 443;
+    bool tls = true;
+    int connectTimeoutMs = 5000;
+    int readTimeoutMs = 10000;
+
+    // "https://host[:port]" ou "http://host[:port]" ; lève invalid_argument sinon
+    static HttpEndpoint parse(const std::string& url);
+};
+
+// Transport GET minimal sous les fetchs Yahoo. Les implémentations gardent leurs
+// connexions ouvertes (keep-alive) entre requêtes et sont utilisables depuis
+// plusieurs threads. get() renvoie le corps d'une réponse 200, runtime_error sinon
+// (y compris à l'expiration de timeoutMs ; 0 = délai de lecture de l'endpoint).
+// httplib : timeoutMs borne la requête entière (échéance totale, connexion comprise).
+// WinHTTP : délai par opération (résolution, connexion, envoi, chaque lecture) ;
+// une réponse qui arrive au goutte-à-goutte peut dépasser timeoutMs au total.
+class HttpTransport {
+public:
+    virtual ~HttpTransport() = default;
+    virtual std::string get(const std::string& path, int timeoutMs = 0) = 0;
+};
+
+// WinHTTP (session + connexion persistantes) sous Windows, pool de clients
+// httplib keep-alive ailleurs. En HTTPS hors Windows, httplib.h doit être compilé
+// avec CPPHTTPLIB_OPENSSL_SUPPORT (-lssl -lcrypto) : voir tools/build_linux.sh.
+std::unique_ptr<HttpTransport> makeHttpTransport(const HttpEndpoint& endpoint);
+
+#endif
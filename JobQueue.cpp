@@ -0,0 +1,166 @@
+#include "JobQueue.hpp"
+#include <algorithm>
+#include <utility>
+
+const char* jobStatusName(JobStatus status) {
+    switch (status) {
+        case JobStatus::Queued: return "queued";
+        case JobStatus::Running: return "running";
+        case JobStatus::Done: return "done";
+        case JobStatus::Failed: return "failed";
+        case JobStatus::Cancelled: return "cancelled";
+    }
+    return "unknown";
+}
+
+void JobContext::progress(double fraction) {
+    progress_.store(std::clamp(fraction, 0.0, 1.0), std::memory_order_relaxed);
+}
+
+JobQueue::JobQueue() : JobQueue(Options{}) {}
+
+JobQueue::JobQueue(Options options) : options_(options) {
+    if (options_.workers == 0) throw std::invalid_argument("JobQueue: workers must be > 0.");
+    workers_.reserve(options_.workers);
+    for (std::size_t i = 0; i < options_.workers; ++i) workers_.emplace_back([this] { run(); });
+}
+
+JobQueue::~JobQueue() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        for (const auto& job : queue_) finish(job, JobStatus::Cancelled);
+        queue_.clear();
+        for (const auto& entry : jobs_) {
+            if (entry.second->info.status == JobStatus::Running) entry.second->context.cancelled_ = true;
+        }
+    }
+    wake_.notify_all();
+    for (auto& t : workers_) t.join();
+}
+
+JobQueue::Submission JobQueue::submit(const std::string& key, Task task) {
+    if (!task) throw std::invalid_argument("JobQueue::submit: task must be callable.");
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!key.empty()) {
+        const auto it = active_.find(key);
+        if (it != active_.end()) {
+            ++stats_.coalesced;
+            return Submission{it->second, true};
+        }
+    }
+    if (queue_.size() >= options_.capacity) {
+        ++stats_.rejected;
+        throw JobQueueFull("JobQueue::submit: queue full (" + std::to_string(options_.capacity) + " jobs waiting).");
+    }
+
+    auto job = std::make_shared<Job>();
+    job->info.id = nextId_++;
+    job->info.key = key;
+    job->task = std::move(task);
+    jobs_.emplace(job->info.id, job);
+    queue_.push_back(job);
+    if (!key.empty()) active_.emplace(key, job->info.id);
+    ++stats_.submitted;
+    wake_.notify_one();
+    return Submission{job->info.id, false};
+}
+
+std::optional<JobInfo> JobQueue::info(std::uint64_t id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = jobs_.find(id);
+    if (it == jobs_.end()) return std::nullopt;
+    JobInfo out = it->second->info;
+    if (out.status == JobStatus::Running) out.progress = it->second->context.progress();
+    return out;
+}
+
+std::vector<JobInfo> JobQueue::recent(std::size_t max) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<JobInfo> out;
+    for (auto it = jobs_.rbegin(); it != jobs_.rend() && out.size() < max; ++it) {
+        out.push_back(it->second->info);
+        if (out.back().status == JobStatus::Running) out.back().progress = it->second->context.progress();
+    }
+    return out;
+}
+
+bool JobQueue::cancel(std::uint64_t id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = jobs_.find(id);
+    if (it == jobs_.end() || it->second->info.finished()) return false;
+    const std::shared_ptr<Job> job = it->second;
+    if (job->info.status == JobStatus::Queued) {
+        queue_.erase(std::find(queue_.begin(), queue_.end(), job));
+        finish(job, JobStatus::Cancelled);
+        return true;
+    }
+    // en cours : la tâche voit cancelled() ; une nouvelle soumission ne s'y rattache plus
+    job->context.cancelled_ = true;
+    const auto active = active_.find(job->info.key);
+    if (active != active_.end() && active->second == id) active_.erase(active);
+    return true;
+}
+
+JobQueue::Stats JobQueue::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats out = stats_;
+    out.queued = queue_.size();
+    out.running = 0;
+    for (const auto& entry : jobs_) {
+        if (entry.second->info.status == JobStatus::Running) ++out.running;
+    }
+    return out;
+}
+
+void JobQueue::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        wake_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+        if (queue_.empty()) return;   // stopping_
+        const std::shared_ptr<Job> job = queue_.front();
+        queue_.pop_front();
+        job->info.status = JobStatus::Running;
+
+        lock.unlock();
+        JobStatus status = JobStatus::Done;
+        std::string result;
+        std::string error;
+        try {
+            result = job->task(job->context);
+        } catch (const JobCancelled&) {
+            status = JobStatus::Cancelled;
+        } catch (const std::exception& e) {
+            status = JobStatus::Failed;
+            error = e.what();
+            if (error.empty()) error = "unknown error";
+        } catch (...) {
+            status = JobStatus::Failed;
+            error = "unknown error";
+        }
+        job->task = nullptr;   // captures (copies de portefeuille, etc.) libérées hors verrou
+        lock.lock();
+
+        job->info.result = std::move(result);
+        job->info.error = std::move(error);
+        finish(job, status);
+    }
+}
+
+void JobQueue::finish(const std::shared_ptr<Job>& job, JobStatus status) {
+    job->info.status = status;
+    job->task = nullptr;
+    job->info.progress = status == JobStatus::Done ? 1.0 : job->context.progress();
+    if (status == JobStatus::Done) ++stats_.done;
+    else if (status == JobStatus::Failed) ++stats_.failed;
+    else ++stats_.cancelled;
+
+    const auto active = active_.find(job->info.key);
+    if (active != active_.end() && active->second == job->info.id) active_.erase(active);
+
+    finished_.push_back(job->info.id);
+    while (finished_.size() > options_.retained) {
+        jobs_.erase(finished_.front());
+        finished_.pop_front();
+    }
+}
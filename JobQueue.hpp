@@ -0,0 +1,134 @@
+#ifndef JOB_QUEUE_HPP
+#define JOB_QUEUE_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+enum class JobStatus { Queued, Running, Done, Failed, Cancelled };
+
+const char* jobStatusName(JobStatus status);   // "queued", "running", ...
+
+// Levée par JobContext::checkCancelled : la tâche s'arrête, le job passe en Cancelled
+struct JobCancelled : std::runtime_error {
+    JobCancelled() : std::runtime_error("job cancelled") {}
+};
+
+// File pleine : submit refuse plutôt que de faire attendre le thread appelant
+struct JobQueueFull : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+// Vue d'une tâche en cours : progression publiée, annulation coopérative
+class JobContext {
+public:
+    bool cancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+    void checkCancelled() const {
+        if (cancelled()) throw JobCancelled();
+    }
+    void progress(double fraction);   // borné à [0, 1]
+    double progress() const { return progress_.load(std::memory_order_relaxed); }
+
+private:
+    friend class JobQueue;
+    std::atomic<bool> cancelled_{false};
+    std::atomic<double> progress_{0.0};
+};
+
+struct JobInfo {
+    std::uint64_t id = 0;
+    std::string key;
+    JobStatus status = JobStatus::Queued;
+    double progress = 0.0;
+    std::string result;   // Done : valeur renvoyée par la tâche
+    std::string error;    // Failed : what() de l'exception
+
+    bool finished() const { return status != JobStatus::Queued && status != JobStatus::Running; }
+};
+
+// File bornée de tâches longues exécutées par un pool de workers. Chaque tâche a un
+// id ; état, progression et résultat se lisent par id tant que le job est retenu.
+// Deux soumissions de même clé (non vide) pendant que la première est en attente ou
+// en cours partagent le même job.
+class JobQueue {
+public:
+    using Task = std::function<std::string(JobContext&)>;
+
+    struct Options {
+        std::size_t workers = 2;
+        std::size_t capacity = 16;   // jobs en attente au plus
+        std::size_t retained = 64;   // jobs terminés gardés pour consultation
+    };
+
+    struct Submission {
+        std::uint64_t id = 0;
+        bool coalesced = false;   // rattachée à un job identique déjà en file ou en cours
+    };
+
+    struct Stats {
+        std::uint64_t submitted = 0;
+        std::uint64_t coalesced = 0;
+        std::uint64_t rejected = 0;   // file pleine
+        std::uint64_t done = 0;
+        std::uint64_t failed = 0;
+        std::uint64_t cancelled = 0;
+        std::size_t queued = 0;
+        std::size_t running = 0;
+    };
+
+    JobQueue();
+    explicit JobQueue(Options options);
+    // Annule les jobs en attente, signale l'annulation aux jobs en cours et les attend
+    ~JobQueue();
+
+    JobQueue(const JobQueue&) = delete;
+    JobQueue& operator=(const JobQueue&) = delete;
+
+    // JobQueueFull si capacity jobs attendent déjà ; invalid_argument si task est vide
+    Submission submit(const std::string& key, Task task);
+
+    std::optional<JobInfo> info(std::uint64_t id) const;
+    std::vector<JobInfo> recent(std::size_t max) const;   // plus récent d'abord
+
+    // En attente : annulé tout de suite. En cours : annulation signalée à la tâche.
+    // false si le job est inconnu ou déjà terminé.
+    bool cancel(std::uint64_t id);
+
+    Stats stats() const;
+
+private:
+    struct Job {
+        JobInfo info;
+        Task task;
+        JobContext context;
+    };
+
+    Options options_;
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    std::uint64_t nextId_ = 1;
+    std::map<std::uint64_t, std::shared_ptr<Job>> jobs_;   // ordonné par id
+    std::deque<std::shared_ptr<Job>> queue_;
+    std::unordered_map<std::string, std::uint64_t> active_;   // clé -> job en attente ou en cours
+    std::deque<std::uint64_t> finished_;   // ordre de fin, pour la rétention
+    Stats stats_;
+    std::vector<std::thread> workers_;
+
+    void run();
+    void finish(const std::shared_ptr<Job>& job, JobStatus status);   // mutex_ tenu
+};
+
+#endif
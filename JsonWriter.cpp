@@ -0,0 +1,124 @@
+#include "JsonWriter.hpp"
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+template <typename T>
+void appendNumber(std::string& out, T x) {
+    char buf[32];
+    const auto r = std::to_chars(buf, buf + sizeof(buf), x);
+    out.append(buf, r.ptr);
+}
+
+} // namespace
+
+void appendJsonEscaped(std::string& out, std::string_view s) {
+    static const char hex[] = "0123456789abcdef";
+    std::size_t run = 0;   // début du segment sans caractère à échapper
+    for (std::size_t i = 0; i < s.size(); ++i) {
+        const unsigned char c = static_cast<unsigned char>(s[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+        out.append(s.data() + run, i - run);
+        run = i + 1;
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default: {
+                const char u[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+                out.append(u, sizeof(u));
+            }
+        }
+    }
+    out.append(s.data() + run, s.size() - run);
+}
+
+JsonWriter& JsonWriter::beginObject() {
+    separate();
+    out_ += '{';
+    ++depth_;
+    comma_ = false;
+    return *this;
+}
+
+JsonWriter& JsonWriter::endObject() {
+    return close('}');
+}
+
+JsonWriter& JsonWriter::beginArray() {
+    separate();
+    out_ += '[';
+    ++depth_;
+    comma_ = false;
+    return *this;
+}
+
+JsonWriter& JsonWriter::endArray() {
+    return close(']');
+}
+
+JsonWriter& JsonWriter::close(char c) {
+    if (depth_ == 0) throw std::logic_error("JsonWriter: unbalanced end of object/array.");
+    --depth_;
+    out_ += c;
+    comma_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::key(std::string_view name) {
+    separate();
+    out_ += '"';
+    appendJsonEscaped(out_, name);
+    out_ += "\":";
+    comma_ = false;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(std::string_view s) {
+    separate();
+    out_ += '"';
+    appendJsonEscaped(out_, s);
+    out_ += '"';
+    comma_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(double x) {
+    if (!std::isfinite(x)) return null();
+    separate();
+    appendNumber(out_, x);
+    comma_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(std::int64_t x) {
+    separate();
+    appendNumber(out_, x);
+    comma_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(std::uint64_t x) {
+    separate();
+    appendNumber(out_, x);
+    comma_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(bool b) {
+    separate();
+    out_ += b ? "true" : "false";
+    comma_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::null() {
+    separate();
+    out_ += "null";
+    comma_ = true;
+    return *this;
+}
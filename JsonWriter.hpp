@@ -0,0 +1,60 @@
+#ifndef JSON_WRITER_HPP
+#define JSON_WRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Écriture JSON en flux, ajoutée à la fin d'un std::string fourni par l'appelant
+// (réutilisable d'une requête à l'autre : clear() garde la capacité). Nombres par
+// std::to_chars (le plus court aller-retour, indépendant de la locale), aucun
+// ostringstream ni chaîne temporaire par champ. NaN et infinis s'écrivent null.
+//
+// La virgule se déduit du jeton précédent : pas de pile, mais pas non plus de
+// contrôle de structure au-delà de la profondeur (logic_error si end* déséquilibré).
+class JsonWriter {
+public:
+    explicit JsonWriter(std::string& out) : out_(out) {}
+
+    JsonWriter& beginObject();
+    JsonWriter& endObject();
+    JsonWriter& beginArray();
+    JsonWriter& endArray();
+
+    JsonWriter& key(std::string_view name);
+
+    JsonWriter& value(std::string_view s);
+    JsonWriter& value(const char* s) { return value(std::string_view(s)); }
+    JsonWriter& value(const std::string& s) { return value(std::string_view(s)); }
+    JsonWriter& value(double x);
+    JsonWriter& value(std::int64_t x);
+    JsonWriter& value(std::uint64_t x);
+    JsonWriter& value(int x) { return value(static_cast<std::int64_t>(x)); }
+    JsonWriter& value(bool b);
+    JsonWriter& null();
+
+    // key(name).value(v)
+    template <typename T>
+    JsonWriter& field(std::string_view name, const T& v) {
+        return key(name).value(v);
+    }
+
+    std::size_t depth() const { return depth_; }
+    bool complete() const { return depth_ == 0 && comma_; }   // une valeur de premier niveau écrite et fermée
+
+private:
+    std::string& out_;
+    std::size_t depth_ = 0;
+    bool comma_ = false;   // le jeton précédent était une valeur : virgule avant le suivant
+
+    void separate() {
+        if (comma_) out_ += ',';
+    }
+    JsonWriter& close(char c);
+};
+
+// s échappé pour un littéral chaîne JSON (sans les guillemets), ajouté à out
+void appendJsonEscaped(std::string& out, std::string_view s);
+
+#endif
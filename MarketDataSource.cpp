@@ -0,0 +1,301 @@
+#include "MarketDataSource.hpp"
+#include "ChartJson.hpp"
+#include "HistoryStore.hpp"
+#include "Yahoo.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace {
+
+std::mutex g_sourceMutex;
+std::shared_ptr<MarketDataSource> g_source;
+
+bool readFile(const std::string& path, std::string& out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t' || s.front() == '"')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r' || s.back() == '"')) s.remove_suffix(1);
+    return s;
+}
+
+std::vector<std::string_view> splitFields(std::string_view line) {
+    std::vector<std::string_view> fields;
+    for (std::size_t pos = 0;;) {
+        const std::size_t comma = line.find(',', pos);
+        fields.push_back(trim(line.substr(pos, comma == std::string_view::npos ? std::string_view::npos : comma - pos)));
+        if (comma == std::string_view::npos) return fields;
+        pos = comma + 1;
+    }
+}
+
+bool equalsNoCase(std::string_view a, const char* b) {
+    const std::size_t n = std::strlen(b);
+    if (a.size() != n) return false;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != b[i]) return false;
+    }
+    return true;
+}
+
+// jours depuis 1970-01-01 d'une date grégorienne (H. Hinnant, days_from_civil)
+std::int64_t daysFromCivil(std::int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const std::int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
+
+// AAAA-MM-JJ (minuit UTC) ou secondes Unix
+bool parseDate(std::string_view s, std::int64_t& out) {
+    const char* p = s.data();
+    const char* end = p + s.size();
+    if (s.size() == 10 && s[4] == '-' && s[7] == '-') {
+        int y = 0, m = 0, d = 0;
+        if (std::from_chars(p, p + 4, y).ptr != p + 4) return false;
+        if (std::from_chars(p + 5, p + 7, m).ptr != p + 7) return false;
+        if (std::from_chars(p + 8, end, d).ptr != end) return false;
+        if (m < 1 || m > 12 || d < 1 || d > 31) return false;
+        out = daysFromCivil(y, static_cast<unsigned>(m), static_cast<unsigned>(d)) * 86400;
+        return true;
+    }
+    const auto r = std::from_chars(p, end, out);
+    return r.ec == std::errc() && r.ptr == end;
+}
+
+bool parseNumber(std::string_view s, double& out) {
+    const auto r = std::from_chars(s.data(), s.data() + s.size(), out);
+    return r.ec == std::errc() && r.ptr == s.data() + s.size();
+}
+
+void parseCsv(const std::string& path, const std::string& text,
+              std::vector<std::int64_t>& timestamps, std::vector<double>& closes) {
+    std::size_t closeColumn = 1;
+    std::size_t lineNo = 0;
+    bool first = true;
+    for (std::size_t pos = 0; pos < text.size();) {
+        std::size_t eol = text.find('\n', pos);
+        if (eol == std::string::npos) eol = text.size();
+        const std::string_view line = trim(std::string_view(text).substr(pos, eol - pos));
+        pos = eol + 1;
+        ++lineNo;
+        if (line.empty() || line.front() == '#') continue;
+
+        const std::vector<std::string_view> fields = splitFields(line);
+        std::int64_t ts = 0;
+        if (first && !parseDate(fields[0], ts)) {
+            // en-tête : colonne Close, à défaut Adj Close
+            std::size_t adj = 0;
+            bool found = false;
+            for (std::size_t c = 1; c < fields.size(); ++c) {
+                if (equalsNoCase(fields[c], "close")) {
+                    closeColumn = c;
+                    found = true;
+                } else if (equalsNoCase(fields[c], "adj close") && !adj) {
+                    adj = c;
+                }
+            }
+            if (!found && adj) closeColumn = adj;
+            else if (!found) throw std::runtime_error("FileMarketData: " + path + ": no close column in header.");
+            first = false;
+            continue;
+        }
+        first = false;
+
+        const std::string where = path + ":" + std::to_string(lineNo);
+        if (!parseDate(fields[0], ts)) throw std::runtime_error("FileMarketData: " + where + ": invalid date.");
+        if (closeColumn >= fields.size()) throw std::runtime_error("FileMarketData: " + where + ": missing close.");
+        const std::string_view field = fields[closeColumn];
+        if (field.empty() || equalsNoCase(field, "null")) continue;
+        double close = 0.0;
+        if (!parseNumber(field, close)) throw std::runtime_error("FileMarketData: " + where + ": invalid close.");
+        if (!timestamps.empty() && ts <= timestamps.back()) {
+            throw std::runtime_error("FileMarketData: " + where + ": dates must be increasing.");
+        }
+        timestamps.push_back(ts);
+        closes.push_back(close);
+    }
+}
+
+void parseChart(const std::string& path, const std::string& json,
+                std::vector<std::int64_t>& timestamps, std::vector<double>& closes) {
+    const ChartSeries chart = parseChartJson(json);
+    if (!chart.hasTimestamps || !chart.hasCloses || chart.timestamps.size() != chart.closes.size()) {
+        throw std::runtime_error("FileMarketData: " + path + ": not a chart response.");
+    }
+    for (std::size_t i = 0; i < chart.closes.size(); ++i) {
+        if (std::isnan(chart.closes[i])) continue;
+        timestamps.push_back(chart.timestamps[i]);
+        closes.push_back(chart.closes[i]);
+    }
+}
+
+} // namespace
+
+double MarketDataSource::latestPrice(const std::string& ticker) {
+    return history(HistoryKey{ticker})->lastPrice;
+}
+
+std::vector<TickerHistory> MarketDataSource::histories(const std::vector<std::string>& tickers,
+                                                       const std::string& range, const std::string& interval) {
+    std::vector<TickerHistory> results(tickers.size());
+    for (std::size_t i = 0; i < tickers.size(); ++i) {
+        TickerHistory& r = results[i];
+        r.ticker = tickers[i];
+        try {
+            r.history = history(HistoryKey{tickers[i], range, interval});
+        } catch (const std::exception& e) {
+            r.history.reset();
+            r.error = e.what();
+            if (r.error.empty()) r.error = "unknown error";
+        }
+    }
+    return results;
+}
+
+std::vector<TickerQuote> MarketDataSource::latestPrices(const std::vector<std::string>& tickers) {
+    std::vector<TickerQuote> quotes;
+    quotes.reserve(tickers.size());
+    for (TickerHistory& r : histories(tickers)) {
+        TickerQuote q;
+        q.ticker = std::move(r.ticker);
+        if (r.ok()) q.price = r.history->lastPrice;
+        else q.error = std::move(r.error);
+        quotes.push_back(std::move(q));
+    }
+    return quotes;
+}
+
+FileMarketData::FileMarketData(std::string directory) : directory_(std::move(directory)) {
+    if (directory_.empty()) throw std::invalid_argument("FileMarketData: directory must not be empty.");
+}
+
+std::shared_ptr<const PriceHistory> FileMarketData::history(const HistoryKey& key) {
+    const std::string k = key.ticker + '\x1f' + key.range + '\x1f' + key.interval;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = loaded_.find(k);
+        if (it != loaded_.end()) return it->second;
+    }
+    // lecture hors verrou ; deux lectures simultanées d'un même fichier donnent le même résultat
+    auto h = std::make_shared<const PriceHistory>(load(key));
+    std::lock_guard<std::mutex> lock(mutex_);
+    return loaded_.emplace(k, std::move(h)).first->second;
+}
+
+PriceHistory FileMarketData::load(const HistoryKey& key) const {
+    const std::string& ticker = key.ticker;
+    if (ticker.empty() || ticker.front() == '.' ||
+        ticker.find_first_of("/\\:") != std::string::npos) {
+        throw std::invalid_argument("FileMarketData: invalid ticker '" + ticker + "'.");
+    }
+
+    if (const auto view = HistoryStore(directory_).open(key)) return view->toPriceHistory(ticker);
+
+    std::vector<std::int64_t> timestamps;
+    std::vector<double> closes;
+    std::string text;
+    const std::string base = directory_ + "/" + ticker;
+    if (readFile(base + ".csv", text)) parseCsv(base + ".csv", text, timestamps, closes);
+    else if (readFile(base + ".json", text)) parseChart(base + ".json", text, timestamps, closes);
+    else throw std::runtime_error("FileMarketData: no data for " + ticker + " in " + directory_ + ".");
+
+    const std::int64_t window = historyRangeSeconds(key.range);
+    if (window > 0 && !timestamps.empty()) {
+        const auto first = std::lower_bound(timestamps.begin(), timestamps.end(), timestamps.back() - window);
+        const std::size_t skip = first - timestamps.begin();
+        timestamps.erase(timestamps.begin(), first);
+        closes.erase(closes.begin(), closes.begin() + (long long)skip);
+    }
+    return PriceHistory::fromCloses(ticker, std::move(timestamps), std::move(closes));
+}
+
+std::shared_ptr<const PriceHistory> InMemoryMarketData::history(const HistoryKey& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = histories_.find(key.ticker);
+    if (it == histories_.end()) throw std::runtime_error("InMemoryMarketData: no history for " + key.ticker + ".");
+    return it->second;
+}
+
+void InMemoryMarketData::set(PriceHistory history) {
+    auto h = std::make_shared<const PriceHistory>(std::move(history));
+    std::lock_guard<std::mutex> lock(mutex_);
+    histories_[h->ticker] = std::move(h);
+}
+
+void InMemoryMarketData::set(const std::string& ticker, std::vector<std::int64_t> timestamps, std::vector<double> closes) {
+    set(PriceHistory::fromCloses(ticker, std::move(timestamps), std::move(closes)));
+}
+
+bool InMemoryMarketData::remove(const std::string& ticker) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return histories_.erase(ticker) > 0;
+}
+
+CorrelationMatrix correlationMatrixFromSource(MarketDataSource& source, const std::vector<std::string>& tickers,
+                                              const AlignOptions& align) {
+    std::vector<TickerHistory> results = source.histories(tickers);
+    std::vector<const PriceHistory*> ptrs;
+    std::string failures;
+    std::size_t failed = 0;
+    for (const TickerHistory& r : results) {
+        if (r.ok()) {
+            ptrs.push_back(r.history.get());
+            continue;
+        }
+        ++failed;
+        failures += " " + r.ticker + " (" + r.error + ");";
+    }
+    if (failed > 0) {
+        throw std::runtime_error(source.name() + " fetch failed for " + std::to_string(failed) + " ticker(s):" + failures);
+    }
+    return AlignedReturns::join(ptrs, align).correlation();
+}
+
+std::shared_ptr<MarketDataSource> makeMarketDataSource(const std::string& spec) {
+    if (spec == "yahoo") return std::make_shared<YahooMarketData>();
+    if (spec == "memory") return std::make_shared<InMemoryMarketData>();
+    if (spec.compare(0, 5, "file:") == 0 && spec.size() > 5) return std::make_shared<FileMarketData>(spec.substr(5));
+    throw std::invalid_argument("makeMarketDataSource: unknown source '" + spec + "' (yahoo, file:<dir>, memory).");
+}
+
+void setMarketDataSource(std::shared_ptr<MarketDataSource> source) {
+    std::lock_guard<std::mutex> lock(g_sourceMutex);
+    g_source = std::move(source);
+}
+
+std::shared_ptr<MarketDataSource> marketDataSource() {
+    std::lock_guard<std::mutex> lock(g_sourceMutex);
+    if (!g_source) {
+        const char* spec = std::getenv("MARKET_DATA");
+        g_source = makeMarketDataSource(spec && *spec ? spec : "yahoo");
+    }
+    return g_source;
+}
+
+std::shared_ptr<MarketDataSource> configureMarketDataSource(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg.compare(0, 7, "--data=") == 0) {
+            setMarketDataSource(makeMarketDataSource(arg.substr(7)));
+            break;
+        }
+    }
+    return marketDataSource();
+}
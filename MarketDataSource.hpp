@@ -0,0 +1,106 @@
+#ifndef MARKET_DATA_SOURCE_HPP
+#define MARKET_DATA_SOURCE_HPP
+
+#include "AlignedReturns.hpp"
+#include "CorrelationMatrix.hpp"
+#include "HistoryCache.hpp"
+#include "PriceHistory.hpp"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Résultat par ticker : history si succès, error (non vide) sinon
+struct TickerHistory {
+    std::string ticker;
+    std::shared_ptr<const PriceHistory> history;
+    std::string error;
+
+    bool ok() const { return error.empty(); }
+};
+
+struct TickerQuote {
+    std::string ticker;
+    double price = 0.0;
+    std::string error;
+
+    bool ok() const { return error.empty(); }
+};
+
+// Fournisseur de données de marché (Yahoo, fichiers rejoués, mémoire). Les appels
+// peuvent venir de plusieurs threads à la fois.
+class MarketDataSource {
+public:
+    virtual ~MarketDataSource() = default;
+
+    virtual std::string name() const = 0;
+
+    // runtime_error si le ticker est indisponible
+    virtual std::shared_ptr<const PriceHistory> history(const HistoryKey& key) = 0;
+    // Dernier close connu (historique 1y/1d par défaut)
+    virtual double latestPrice(const std::string& ticker);
+
+    // Un résultat par ticker, dans l'ordre d'entrée ; un échec n'interrompt pas les autres.
+    // Séquentiel par défaut.
+    virtual std::vector<TickerHistory> histories(const std::vector<std::string>& tickers,
+                                                 const std::string& range = "1y",
+                                                 const std::string& interval = "1d");
+    virtual std::vector<TickerQuote> latestPrices(const std::vector<std::string>& tickers);
+};
+
+// Répertoire d'historiques enregistrés (rejeu hors ligne), pour chaque ticker :
+//   1. <dir>/<fichier du HistoryStore>.phs pour la clé (sans contrôle d'âge) ;
+//   2. <dir>/<TICKER>.csv : "date,close" ou export Yahoo (Date,Open,High,Low,Close,Adj Close,Volume),
+//      date AAAA-MM-JJ ou secondes Unix, lignes croissantes, closes null/vides ignorés ;
+//   3. <dir>/<TICKER>.json : réponse chart Yahoo enregistrée.
+// Les CSV/JSON sont ramenés à key.range avant la dernière barre ; l'intervalle est
+// celui du fichier. Les fichiers sont lus une fois puis gardés en mémoire.
+class FileMarketData : public MarketDataSource {
+public:
+    explicit FileMarketData(std::string directory);
+
+    std::string name() const override { return "file:" + directory_; }
+    std::shared_ptr<const PriceHistory> history(const HistoryKey& key) override;
+
+    const std::string& directory() const { return directory_; }
+
+private:
+    std::string directory_;
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<const PriceHistory>> loaded_;
+
+    PriceHistory load(const HistoryKey& key) const;
+};
+
+// Historiques fixés à la main (tests, démonstrations) ; range/interval ignorés
+class InMemoryMarketData : public MarketDataSource {
+public:
+    std::string name() const override { return "memory"; }
+    std::shared_ptr<const PriceHistory> history(const HistoryKey& key) override;
+
+    void set(PriceHistory history);
+    void set(const std::string& ticker, std::vector<std::int64_t> timestamps, std::vector<double> closes);
+    bool remove(const std::string& ticker);
+
+private:
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<const PriceHistory>> histories_;
+};
+
+// Corrélation alignée par date des tickers fournis (labels = tickers) ;
+// runtime_error listant chaque ticker en échec
+CorrelationMatrix correlationMatrixFromSource(MarketDataSource& source, const std::vector<std::string>& tickers,
+                                              const AlignOptions& align = {});
+
+// "yahoo", "file:<répertoire>" ou "memory" ; invalid_argument sinon
+std::shared_ptr<MarketDataSource> makeMarketDataSource(const std::string& spec);
+
+// Source utilisée par la CLI et l'UI. Par défaut : variable MARKET_DATA, sinon Yahoo.
+void setMarketDataSource(std::shared_ptr<MarketDataSource> source);
+std::shared_ptr<MarketDataSource> marketDataSource();
+
+// Choix au démarrage : argument --data=<spec>, sinon MARKET_DATA, sinon Yahoo
+std::shared_ptr<MarketDataSource> configureMarketDataSource(int argc, char** argv);
+
+#endif
@@ -0,0 +1,252 @@
+#include "OnlineStats.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+double decayForHalfLife(double halfLife, const char* who) {
+    if (!(halfLife > 0.0) || !std::isfinite(halfLife)) {
+        throw std::invalid_argument(std::string(who) + ": halfLife must be > 0.");
+    }
+    return std::exp(-std::log(2.0) / halfLife);
+}
+
+// corr(i,j) = C_ij / sqrt(C_ii C_jj) : indépendant de la normalisation des co-moments
+CorrelationMatrix correlationFromComoments(const SymmetricMatrix& c, std::vector<std::string> labels) {
+    const std::size_t n = c.size();
+    CorrelationMatrix corr(n);
+    corr.setLabels(std::move(labels));
+    std::vector<double> sd(n);
+    for (std::size_t i = 0; i < n; ++i) sd[i] = std::sqrt(std::max(0.0, c.row(i)[0]));
+    for (std::size_t i = 0; i < n; ++i) {
+        const double* src = c.row(i);
+        double* dst = corr.row(i);
+        for (std::size_t j = i + 1; j < n; ++j) {
+            if (sd[i] <= 0.0 || sd[j] <= 0.0) continue;   // série constante
+            dst[j - i] = std::clamp(src[j - i] / (sd[i] * sd[j]), -1.0, 1.0);
+        }
+    }
+    return corr;
+}
+
+// C += f · d d' (triangle supérieur)
+void addOuter(SymmetricMatrix& c, const std::vector<double>& d, double f) {
+    const std::size_t n = d.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        const double di = f * d[i];
+        double* dst = c.row(i);
+        for (std::size_t j = i; j < n; ++j) dst[j - i] += di * d[j];
+    }
+}
+
+CovarianceMatrix scaledCovariance(const SymmetricMatrix& c, double scale, std::vector<std::string> labels) {
+    const std::size_t n = c.size();
+    CovarianceMatrix cov(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const double* src = c.row(i);
+        double* dst = cov.row(i);
+        for (std::size_t j = i; j < n; ++j) dst[j - i] = src[j - i] * scale;
+    }
+    cov.setLabels(std::move(labels));
+    return cov;
+}
+
+} // namespace
+
+void RunningStats::add(double x) {
+    ++n_;
+    const double d = x - mean_;
+    mean_ += d / (double)n_;
+    m2_ += d * (x - mean_);
+}
+
+void RunningStats::remove(double x) {
+    if (n_ == 0) throw std::out_of_range("RunningStats::remove: no values.");
+    if (n_ == 1) {
+        clear();
+        return;
+    }
+    // inverse de add : moyenne sans x, puis retrait de (x - m')(x - m)
+    const double previous = mean_ + (mean_ - x) / (double)(n_ - 1);
+    m2_ = std::max(0.0, m2_ - (x - previous) * (x - mean_));
+    mean_ = previous;
+    --n_;
+}
+
+void RunningStats::merge(const RunningStats& other) {
+    if (other.n_ == 0) return;
+    if (n_ == 0) {
+        *this = other;
+        return;
+    }
+    const double n = (double)(n_ + other.n_);
+    const double d = other.mean_ - mean_;
+    mean_ += d * (double)other.n_ / n;
+    m2_ += other.m2_ + d * d * (double)n_ * (double)other.n_ / n;
+    n_ += other.n_;
+}
+
+double RunningStats::variance() const {
+    return n_ > 1 ? m2_ / (double)(n_ - 1) : 0.0;
+}
+
+double RunningStats::stddev() const {
+    return std::sqrt(variance());
+}
+
+EwmaStats::EwmaStats(double halfLife) : halfLife_(halfLife), decay_(decayForHalfLife(halfLife, "EwmaStats")) {}
+
+void EwmaStats::add(double x) {
+    ++n_;
+    weight_ = decay_ * weight_ + 1.0;
+    const double d = x - mean_;
+    mean_ += d / weight_;
+    m2_ = decay_ * m2_ + d * (x - mean_);
+}
+
+void EwmaStats::clear() {
+    n_ = 0;
+    weight_ = mean_ = m2_ = 0.0;
+}
+
+double EwmaStats::stddev() const {
+    return std::sqrt(std::max(0.0, variance()));
+}
+
+void RunningCoMoment::add(double x, double y) {
+    ++n_;
+    const double dx = x - mx_;
+    const double dy = y - my_;
+    mx_ += dx / (double)n_;
+    my_ += dy / (double)n_;
+    cxx_ += dx * (x - mx_);
+    cyy_ += dy * (y - my_);
+    cxy_ += dx * (y - my_);
+}
+
+double RunningCoMoment::correlation() const {
+    if (cxx_ <= 0.0 || cyy_ <= 0.0) return 0.0;
+    return std::clamp(cxy_ / std::sqrt(cxx_ * cyy_), -1.0, 1.0);
+}
+
+RunningCovariance::RunningCovariance(std::size_t series)
+    : mean_(series, 0.0), delta_(series, 0.0), comoment_(series, 0.0) {}
+
+void RunningCovariance::add(const double* row) {
+    const std::size_t n = series();
+    if (!row && n > 0) throw std::invalid_argument("RunningCovariance::add: row must be non-null.");
+    ++n_;
+    for (std::size_t i = 0; i < n; ++i) {
+        delta_[i] = row[i] - mean_[i];
+        mean_[i] += delta_[i] / (double)n_;
+    }
+    // (x - m_avant)(x - m_après)' = (n-1)/n · d d'
+    addOuter(comoment_, delta_, (double)(n_ - 1) / (double)n_);
+}
+
+void RunningCovariance::remove(const double* row) {
+    const std::size_t n = series();
+    if (n_ == 0) throw std::out_of_range("RunningCovariance::remove: no rows.");
+    if (!row && n > 0) throw std::invalid_argument("RunningCovariance::remove: row must be non-null.");
+    if (n_ == 1) {
+        clear();
+        return;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        delta_[i] = row[i] - mean_[i];
+        mean_[i] -= delta_[i] / (double)(n_ - 1);
+    }
+    addOuter(comoment_, delta_, -(double)n_ / (double)(n_ - 1));
+    --n_;
+}
+
+void RunningCovariance::clear() {
+    n_ = 0;
+    std::fill(mean_.begin(), mean_.end(), 0.0);
+    comoment_ = SymmetricMatrix(series(), 0.0);
+}
+
+double RunningCovariance::covariance(std::size_t i, std::size_t j) const {
+    return n_ > 1 ? comoment_.at(i, j) / (double)(n_ - 1) : 0.0;
+}
+
+CovarianceMatrix RunningCovariance::covariance(std::vector<std::string> labels) const {
+    return scaledCovariance(comoment_, n_ > 1 ? 1.0 / (double)(n_ - 1) : 0.0, std::move(labels));
+}
+
+CorrelationMatrix RunningCovariance::correlation(std::vector<std::string> labels) const {
+    return correlationFromComoments(comoment_, std::move(labels));
+}
+
+EwmaCovariance::EwmaCovariance(std::size_t series, double halfLife)
+    : halfLife_(halfLife), decay_(decayForHalfLife(halfLife, "EwmaCovariance")),
+      mean_(series, 0.0), delta_(series, 0.0), comoment_(series, 0.0) {}
+
+void EwmaCovariance::add(const double* row) {
+    const std::size_t n = series();
+    if (!row && n > 0) throw std::invalid_argument("EwmaCovariance::add: row must be non-null.");
+    ++n_;
+    weight_ = decay_ * weight_ + 1.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        delta_[i] = row[i] - mean_[i];
+        mean_[i] += delta_[i] / weight_;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        double* dst = comoment_.row(i);
+        for (std::size_t j = i; j < n; ++j) dst[j - i] *= decay_;
+    }
+    addOuter(comoment_, delta_, 1.0 - 1.0 / weight_);
+}
+
+void EwmaCovariance::clear() {
+    n_ = 0;
+    weight_ = 0.0;
+    std::fill(mean_.begin(), mean_.end(), 0.0);
+    comoment_ = SymmetricMatrix(series(), 0.0);
+}
+
+CovarianceMatrix EwmaCovariance::covariance(std::vector<std::string> labels) const {
+    return scaledCovariance(comoment_, weight_ > 0.0 ? 1.0 / weight_ : 0.0, std::move(labels));
+}
+
+CorrelationMatrix EwmaCovariance::correlation(std::vector<std::string> labels) const {
+    return correlationFromComoments(comoment_, std::move(labels));
+}
+
+OnlineReturnStats::OnlineReturnStats(std::vector<std::string> labels, double halfLife)
+    : labels_(std::move(labels)),
+      last_(labels_.size(), 0.0),
+      returns_(labels_.size(), 0.0),
+      stats_(labels_.size()),
+      ewma_(labels_.size(), EwmaStats(halfLife)),
+      cov_(labels_.size()),
+      ewmaCov_(labels_.size(), halfLife) {}
+
+bool OnlineReturnStats::addPrices(const double* prices) {
+    const std::size_t n = series();
+    if (!prices && n > 0) throw std::invalid_argument("OnlineReturnStats::addPrices: prices must be non-null.");
+    for (std::size_t i = 0; i < n; ++i) {
+        if (!(prices[i] > 0.0) || !std::isfinite(prices[i])) return false;
+    }
+    if (primed_) {
+        for (std::size_t i = 0; i < n; ++i) returns_[i] = std::log(prices[i] / last_[i]);
+        addReturns(returns_.data());
+    }
+    std::copy(prices, prices + n, last_.begin());
+    const bool produced = primed_;
+    primed_ = true;
+    return produced;
+}
+
+void OnlineReturnStats::addReturns(const double* returns) {
+    const std::size_t n = series();
+    if (!returns && n > 0) throw std::invalid_argument("OnlineReturnStats::addReturns: returns must be non-null.");
+    for (std::size_t i = 0; i < n; ++i) {
+        stats_[i].add(returns[i]);
+        ewma_[i].add(returns[i]);
+    }
+    cov_.add(returns);
+    ewmaCov_.add(returns);
+}
@@ -0,0 +1,161 @@
+#ifndef ONLINE_STATS_HPP
+#define ONLINE_STATS_HPP
+
+#include "CorrelationMatrix.hpp"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Moyenne et variance de Welford : ajout et retrait en O(1), sans la perte de
+// précision de Σx² - (Σx)²/n quand la moyenne est grande devant l'écart-type.
+class RunningStats {
+public:
+    void add(double x);
+    // x doit faire partie des valeurs ajoutées (fenêtre glissante) ; out_of_range si vide
+    void remove(double x);
+    void merge(const RunningStats& other);
+    void clear() { *this = RunningStats(); }
+
+    std::size_t count() const { return n_; }
+    double mean() const { return mean_; }
+    double variance() const;   // échantillon (n - 1), 0 si n < 2
+    double stddev() const;
+
+private:
+    std::size_t n_ = 0;
+    double mean_ = 0.0;
+    double m2_ = 0.0;   // Σ (x - moyenne)²
+};
+
+// Moyenne et variance pondérées exponentiellement : poids 1/2 au bout de halfLife
+// observations. variance() = Σ w (x - moyenne)² / Σ w.
+class EwmaStats {
+public:
+    explicit EwmaStats(double halfLife);   // invalid_argument si halfLife <= 0
+
+    void add(double x);
+    void clear();
+
+    double halfLife() const { return halfLife_; }
+    double decay() const { return decay_; }
+    std::size_t count() const { return n_; }
+    double mean() const { return mean_; }
+    double variance() const { return weight_ > 0.0 ? m2_ / weight_ : 0.0; }
+    double stddev() const;
+
+private:
+    double halfLife_;
+    double decay_;
+    std::size_t n_ = 0;
+    double weight_ = 0.0;   // Σ w
+    double mean_ = 0.0;
+    double m2_ = 0.0;
+};
+
+// Co-moment de deux séries (dates communes d'une paire)
+class RunningCoMoment {
+public:
+    void add(double x, double y);
+
+    std::size_t count() const { return n_; }
+    double covariance() const { return n_ > 1 ? cxy_ / (double)(n_ - 1) : 0.0; }
+    double correlation() const;   // 0 pour une série constante
+
+private:
+    std::size_t n_ = 0;
+    double mx_ = 0.0;
+    double my_ = 0.0;
+    double cxx_ = 0.0;
+    double cyy_ = 0.0;
+    double cxy_ = 0.0;
+};
+
+// Co-moments de n séries (triangle compacté) : une ligne ajoutée ou retirée coûte
+// O(n²), covariance et corrélation se lisent sans repasser sur les données.
+class RunningCovariance {
+public:
+    explicit RunningCovariance(std::size_t series = 0);
+
+    std::size_t series() const { return mean_.size(); }
+    std::size_t count() const { return n_; }
+    const std::vector<double>& mean() const { return mean_; }
+
+    // row : series() valeurs
+    void add(const double* row);
+    // row doit faire partie des lignes ajoutées ; out_of_range si vide
+    void remove(const double* row);
+    void clear();
+
+    // Σ (x_i - m_i)(x_j - m_j), triangle compacté
+    const SymmetricMatrix& comoments() const { return comoment_; }
+    double covariance(std::size_t i, std::size_t j) const;
+    CovarianceMatrix covariance(std::vector<std::string> labels = {}) const;   // / (n - 1)
+    CorrelationMatrix correlation(std::vector<std::string> labels = {}) const;
+
+private:
+    std::size_t n_ = 0;
+    std::vector<double> mean_;
+    std::vector<double> delta_;   // x - moyenne, réutilisé d'une ligne à l'autre
+    SymmetricMatrix comoment_;
+};
+
+// Covariance pondérée exponentiellement (demi-vie en observations)
+class EwmaCovariance {
+public:
+    EwmaCovariance(std::size_t series, double halfLife);
+
+    std::size_t series() const { return mean_.size(); }
+    std::size_t count() const { return n_; }
+    double halfLife() const { return halfLife_; }
+    const std::vector<double>& mean() const { return mean_; }
+
+    void add(const double* row);
+    void clear();
+
+    CovarianceMatrix covariance(std::vector<std::string> labels = {}) const;   // Σ w (x - m)(x - m)' / Σ w
+    CorrelationMatrix correlation(std::vector<std::string> labels = {}) const;
+
+private:
+    double halfLife_;
+    double decay_;
+    std::size_t n_ = 0;
+    double weight_ = 0.0;
+    std::vector<double> mean_;
+    std::vector<double> delta_;
+    SymmetricMatrix comoment_;
+};
+
+// Flux de prix (une ligne par barre, une valeur par série) : log-returns contre la
+// barre précédente, statistiques cumulées et EWMA mises à jour à chaque barre.
+// La première barre ne fait qu'amorcer ; une barre contenant un prix <= 0 ou NaN
+// est ignorée entièrement.
+class OnlineReturnStats {
+public:
+    OnlineReturnStats(std::vector<std::string> labels, double halfLife);
+
+    std::size_t series() const { return labels_.size(); }
+    const std::vector<std::string>& labels() const { return labels_; }
+
+    // false si la barre n'a produit aucun rendement (amorçage ou prix invalide)
+    bool addPrices(const double* prices);
+    void addReturns(const double* returns);
+
+    const RunningStats& stats(std::size_t i) const { return stats_[i]; }
+    const EwmaStats& ewma(std::size_t i) const { return ewma_[i]; }
+    CovarianceMatrix covariance() const { return cov_.covariance(labels_); }
+    CorrelationMatrix correlation() const { return cov_.correlation(labels_); }
+    CovarianceMatrix ewmaCovariance() const { return ewmaCov_.covariance(labels_); }
+    CorrelationMatrix ewmaCorrelation() const { return ewmaCov_.correlation(labels_); }
+
+private:
+    std::vector<std::string> labels_;
+    std::vector<double> last_;
+    std::vector<double> returns_;
+    bool primed_ = false;
+    std::vector<RunningStats> stats_;
+    std::vector<EwmaStats> ewma_;
+    RunningCovariance cov_;
+    EwmaCovariance ewmaCov_;
+};
+
+#endif
@@ -1,10 +1,14 @@
 #include "Portfolio.hpp"
+#include "RiskKernels.hpp"
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <stdexcept>
 #include <limits>
 #include <set>
-Position::Position(const Asset& a, double q) : asset(a), quantity(q) {
+#include <type_traits>
+#include <utility>
+Position::Position(const Asset& a, double q) : asset(a), quantity(q), id(a.id()) {
     if (q <= 0.0) throw std::invalid_argument("Position: quantity must be > 0.");
 }
 
@@ -12,17 +16,136 @@ double Position::value() const { return asset.price() * quantity; }
 
 std::size_t Portfolio::size() const { return positions_.size(); }
 
+// deux compteurs croissants : la somme change dès que l'un des deux bouge
+std::uint64_t Portfolio::version() const {
+    syncHoldingsTicks();
+    return version_ + holdingsTicks_;
+}
+
+// O(1) si aucune écriture partagée depuis le dernier contrôle, sinon balayage O(n)
+// des époques des actifs détenus
+void Portfolio::syncHoldingsTicks() const {
+    const std::uint64_t epoch = assetPriceEpoch();
+    if (epoch == holdingsEpoch_) return;
+    for (const Position& pos : positions_) {
+        if (pos.asset.priceEpoch() > holdingsEpoch_) {
+            ++holdingsTicks_;
+            break;
+        }
+    }
+    holdingsEpoch_ = epoch;
+}
+
+const std::vector<std::uint32_t>& Portfolio::lexicalOrder() const {
+    if (orderVersion_ == structureVersion_) return lexOrder_;
+
+    const std::size_t n = positions_.size();
+    lexOrder_.resize(n);
+    for (std::size_t i = 0; i < n; ++i) lexOrder_[i] = static_cast<std::uint32_t>(i);
+    std::sort(lexOrder_.begin(), lexOrder_.end(), [&](std::uint32_t a, std::uint32_t b) {
+        return positions_[a].asset.name() < positions_[b].asset.name();
+    });
+
+    orderNames_.clear();
+    orderNames_.reserve(n);
+    rankOf_.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        orderNames_.push_back(positions_[lexOrder_[i]].asset.name());
+        rankOf_[lexOrder_[i]] = static_cast<std::uint32_t>(i);
+    }
+
+    orderVersion_ = structureVersion_;
+    return lexOrder_;
+}
+
+Position* Portfolio::findSlot(const std::string& assetName) {
+    const AssetId id = SymbolTable::global().find(assetName);
+    if (id == kInvalidAssetId) return nullptr;
+    auto it = slotOf_.find(id);
+    return it == slotOf_.end() ? nullptr : &positions_[it->second];
+}
+
+// retrait O(1) : le dernier slot prend la place du slot libéré
+void Portfolio::eraseSlot(std::uint32_t slot) {
+    const std::uint32_t last = static_cast<std::uint32_t>(positions_.size() - 1);
+    slotOf_.erase(positions_[slot].id);
+    if (slot != last) {
+        positions_[slot] = std::move(positions_[last]);
+        slotOf_[positions_[slot].id] = slot;
+    }
+    positions_.pop_back();
+    ++structureVersion_;
+}
+
+const Position* Portfolio::find(AssetId id) const {
+    auto it = slotOf_.find(id);
+    return it == slotOf_.end() ? nullptr : &positions_[it->second];
+}
+
+const Position* Portfolio::find(const std::string& assetName) const {
+    return const_cast<Portfolio*>(this)->findSlot(assetName);
+}
+
+const Position& Portfolio::positionAt(std::size_t k) const {
+    const auto& order = lexicalOrder();
+    if (k >= order.size()) throw std::out_of_range("positionAt: index out of range.");
+    return positions_[order[k]];
+}
+
+const PortfolioSnapshot& Portfolio::snapshot() const {
+    syncHoldingsTicks();
+    if (snapshotVersion_ == version_ && snapshotTicks_ == holdingsTicks_) return snapshot_;
+
+    PortfolioSnapshot& s = snapshot_;
+    const std::size_t n = positions_.size();
+    s.n = n;
+    s.mu.resize(n);
+    s.sigma.resize(n);
+    s.price.resize(n);
+    s.qty.resize(n);
+    s.value.resize(n);
+    s.weight.resize(n);
+
+    double total = 0.0;
+    std::size_t i = 0;
+    for (std::uint32_t slot : lexicalOrder()) {
+        const Position& pos = positions_[slot];
+        s.mu[i] = pos.asset.expectedReturn();
+        s.sigma[i] = pos.asset.volatility();
+        s.price[i] = pos.asset.price();
+        s.qty[i] = pos.quantity;
+        s.value[i] = pos.value();
+        total += s.value[i];
+        ++i;
+    }
+    s.totalValue = total;
+    for (i = 0; i < n; ++i) s.weight[i] = total > 0.0 ? s.value[i] / total : 0.0;
+
+    snapshotVersion_ = version_;
+    snapshotTicks_ = holdingsTicks_;
+    return s;
+}
+
 void Portfolio::addPosition(const Asset& a, double quantity) {
     if (quantity <= 0.0) throw std::invalid_argument("addPosition: quantity must be > 0.");
 
-    auto it = positions_.find(a.name());
-    if (it == positions_.end()) {
-        positions_.emplace(a.name(), Position(a, quantity));
+    const AssetId id = a.id();
+    auto it = slotOf_.find(id);
+    if (it == slotOf_.end()) {
+        positions_.emplace_back(a, quantity);
+        slotOf_.emplace(id, static_cast<std::uint32_t>(positions_.size() - 1));
+        ++structureVersion_;
+        ++version_;
+        if (tracker_) {
+            if (tracker_->index.count(id) == 0) tracker_.reset(); // hors univers
+            else trackValueChange(id, a.volatility() * a.price() * quantity);
+        }
         return;
     }
 
     // vérification de cohérence des paramètres d’actif
-    const Asset& existing = it->second.asset;
+    Position& pos = positions_[it->second];
+    const Asset& existing = pos.asset;
     const double eps = 1e-12;
     if (std::fabs(existing.expectedReturn() - a.expectedReturn()) > eps ||
         std::fabs(existing.volatility() - a.volatility()) > eps) {
@@ -30,72 +153,263 @@ void Portfolio::addPosition(const Asset& a, double quantity) {
     }
 
     // Le prix peut varier dans le temps, on accepte le prix du "existing" ici.
-    it->second.quantity += quantity;
+    pos.quantity += quantity;
+    ++version_;
+    if (tracker_) trackValueChange(id, existing.volatility() * pos.value());
 }
 
 void Portfolio::removePosition(const std::string& assetName, double quantity) {
     if (quantity <= 0.0) throw std::invalid_argument("removePosition: quantity must be > 0.");
 
-    auto it = positions_.find(assetName);
-    if (it == positions_.end()) throw std::out_of_range("removePosition: asset not found: " + assetName);
+    Position* pos = findSlot(assetName);
+    if (!pos) throw std::out_of_range("removePosition: asset not found: " + assetName);
 
-    if (quantity > it->second.quantity) {
+    if (quantity > pos->quantity) {
         throw std::invalid_argument("removePosition: quantity exceeds current position.");
     }
 
-    it->second.quantity -= quantity;
-    if (it->second.quantity <= 0.0) positions_.erase(it);
+    const AssetId id = pos->id;
+    pos->quantity -= quantity;
+    const double z = pos->quantity <= 0.0 ? 0.0 : pos->asset.volatility() * pos->value();
+    if (pos->quantity <= 0.0) eraseSlot(slotOf_.at(id));
+    ++version_;
+    if (tracker_) trackValueChange(id, z);
+}
+
+void Portfolio::replaceAsset(const Asset& a) {
+    auto it = slotOf_.find(a.id());
+    if (it == slotOf_.end()) throw std::out_of_range("replaceAsset: asset not found: " + a.name());
+
+    Position& pos = positions_[it->second];
+    pos.asset = a;
+    ++version_;
+    if (tracker_) trackValueChange(pos.id, a.volatility() * pos.value());
+}
+
+void Portfolio::setPrice(const std::string& assetName, double price) {
+    Position* pos = findSlot(assetName);
+    if (!pos) throw std::out_of_range("setPrice: asset not found: " + assetName);
+
+    // surcharge locale : les autres détenteurs gardent le prix partagé
+    pos->asset.setPrice(price);
+    ++version_;
+    if (tracker_) trackValueChange(pos->id, pos->asset.volatility() * pos->value());
+}
+
+std::vector<AssetId> Portfolio::applyPrices(const PriceTick* ticks, std::size_t count) {
+    for (std::size_t t = 0; t < count; ++t) {
+        if (!(ticks[t].price >= 0.0)) throw std::invalid_argument("applyPrices: price must be >= 0.");
+    }
+
+    // dernier prix par slot (le dernier tick d'un actif l'emporte), actifs non détenus ignorés
+    const std::size_t n = positions_.size();
+    std::vector<double> last(n);
+    std::vector<char> seen(n, 0);
+    std::vector<std::uint32_t> touched;
+    for (std::size_t t = 0; t < count; ++t) {
+        auto it = slotOf_.find(ticks[t].id);
+        if (it == slotOf_.end()) continue;
+        if (!seen[it->second]) {
+            seen[it->second] = 1;
+            touched.push_back(it->second);
+        }
+        last[it->second] = ticks[t].price;
+    }
+
+    std::vector<AssetId> moved;
+    std::vector<std::uint32_t> movedSlots;
+    for (std::uint32_t slot : touched) {
+        Position& pos = positions_[slot];
+        if (pos.asset.price() == last[slot]) continue;
+        pos.asset.setPrice(last[slot]);
+        moved.push_back(pos.id);
+        movedSlots.push_back(slot);
+    }
+    if (moved.empty()) return moved;
+
+    // snapshot à jour avant le lot : on ne patche que les lignes touchées,
+    // puis une passe O(n) pour le total et les poids
+    syncHoldingsTicks();
+    const bool patchSnapshot = snapshotVersion_ == version_ && snapshotTicks_ == holdingsTicks_;
+    ++version_;
+    if (patchSnapshot) {
+        PortfolioSnapshot& s = snapshot_;   // rankOf_ est à jour : pas de changement de structure
+        for (std::uint32_t slot : movedSlots) {
+            const std::size_t i = rankOf_[slot];
+            s.price[i] = positions_[slot].asset.price();
+            s.value[i] = positions_[slot].value();
+        }
+        double total = 0.0;
+        for (std::size_t i = 0; i < s.n; ++i) total += s.value[i];
+        s.totalValue = total;
+        for (std::size_t i = 0; i < s.n; ++i) s.weight[i] = total > 0.0 ? s.value[i] / total : 0.0;
+        snapshotVersion_ = version_;
+    }
+
+    if (tracker_) {
+        // au-delà de n/2 mises à jour de rang 1, le recalcul complet est moins cher
+        if (2 * movedSlots.size() > tracker_->corr->size()) {
+            tracker_->stale = true;
+        } else {
+            for (std::uint32_t slot : movedSlots) {
+                const Position& pos = positions_[slot];
+                trackValueChange(pos.id, pos.asset.volatility() * pos.value());
+            }
+        }
+    }
+    return moved;
+}
+
+std::vector<AssetId> Portfolio::applyPrices(const std::vector<PriceTick>& ticks) {
+    return applyPrices(ticks.data(), ticks.size());
 }
 
 Position& Portfolio::operator[](const std::string& assetName) {
-    auto it = positions_.find(assetName);
-    if (it == positions_.end()) throw std::out_of_range("operator[]: asset not found: " + assetName);
-    return it->second;
+    Position* pos = findSlot(assetName);
+    if (!pos) throw std::out_of_range("operator[]: asset not found: " + assetName);
+    ++version_; // l'appelant peut modifier la position : on invalide le snapshot
+    if (tracker_) tracker_->stale = true;
+    return *pos;
 }
 
 const Position& Portfolio::operator[](const std::string& assetName) const {
-    auto it = positions_.find(assetName);
-    if (it == positions_.end()) throw std::out_of_range("operator[] const: asset not found: " + assetName);
-    return it->second;
+    const Position* pos = find(assetName);
+    if (!pos) throw std::out_of_range("operator[] const: asset not found: " + assetName);
+    return *pos;
+}
+
+// Contrôle préalable (mu/sigma identiques pour un même ticker) puis fusion :
+// en cas d'incohérence, rien n'est modifié.
+void Portfolio::checkMergeable(const Portfolio& other) const {
+    const double eps = 1e-12;
+    for (const Position& pos : other.positions_) {
+        const Position* existing = find(pos.id);
+        if (!existing) continue;
+        if (std::fabs(existing->asset.expectedReturn() - pos.asset.expectedReturn()) > eps ||
+            std::fabs(existing->asset.volatility() - pos.asset.volatility()) > eps) {
+            throw std::invalid_argument("mergeFrom: asset parameters mismatch for same name (mu/sigma): " +
+                                        pos.asset.name());
+        }
+    }
+}
+
+template <typename Source>
+void Portfolio::mergePositions(Source&& other) {
+    positions_.reserve(positions_.size() + other.positions_.size());
+    slotOf_.reserve(positions_.size() + other.positions_.size());
+
+    bool added = false;
+    bool outsideUniverse = false;
+    for (auto& pos : other.positions_) {
+        auto it = slotOf_.find(pos.id);
+        if (it != slotOf_.end()) {
+            positions_[it->second].quantity += pos.quantity;   // le prix existant est conservé
+            continue;
+        }
+        if (tracker_ && tracker_->index.count(pos.id) == 0) outsideUniverse = true;
+        slotOf_.emplace(pos.id, static_cast<std::uint32_t>(positions_.size()));
+        if constexpr (std::is_const_v<std::remove_reference_t<Source>>) positions_.push_back(pos);
+        else positions_.push_back(std::move(pos));
+        added = true;
+    }
+
+    if (added) ++structureVersion_;
+    ++version_;
+    if (tracker_) {
+        if (outsideUniverse) tracker_.reset();
+        else tracker_->stale = true;   // une seule reconstruction O(n^2) au lieu de m rangs 1
+    }
+}
+
+void Portfolio::mergeFrom(const Portfolio& other) {
+    if (&other == this) {
+        for (Position& pos : positions_) pos.quantity *= 2.0;
+        ++version_;
+        if (tracker_) tracker_->stale = true;
+        return;
+    }
+    checkMergeable(other);
+    mergePositions(other);
+}
+
+void Portfolio::mergeFrom(Portfolio&& other) {
+    if (&other == this) {
+        mergeFrom(static_cast<const Portfolio&>(other));
+        return;
+    }
+    checkMergeable(other);
+    mergePositions(std::move(other));
+    other.positions_.clear();
+    other.slotOf_.clear();
+    ++other.structureVersion_;
+    ++other.version_;
+    other.tracker_.reset();
+}
+
+Portfolio Portfolio::mergeAll(const std::vector<Portfolio>& parts) {
+    Portfolio out;
+    std::size_t upper = 0;
+    for (const Portfolio& part : parts) upper += part.positions_.size();
+    out.positions_.reserve(upper);
+    out.slotOf_.reserve(upper);
+    for (const Portfolio& part : parts) out.mergeFrom(part);
+    return out;
+}
+
+Portfolio Portfolio::mergeAll(std::vector<Portfolio>&& parts) {
+    Portfolio out;
+    std::size_t upper = 0;
+    for (const Portfolio& part : parts) upper += part.positions_.size();
+    out.positions_.reserve(upper);
+    out.slotOf_.reserve(upper);
+    for (Portfolio& part : parts) out.mergeFrom(std::move(part));
+    return out;
 }
 
 Portfolio operator+(const Portfolio& lhs, const Portfolio& rhs) {
     Portfolio out = lhs;
-    for (const auto& [name, pos] : rhs.positions_) {
-        out.addPosition(pos.asset, pos.quantity);
-    }
+    out.mergeFrom(rhs);
     return out;
 }
 
+Portfolio operator+(Portfolio&& lhs, const Portfolio& rhs) {
+    lhs.mergeFrom(rhs);
+    return std::move(lhs);
+}
+
+Portfolio operator+(const Portfolio& lhs, Portfolio&& rhs) {
+    // les prix de lhs priment : on part de lhs, on déplace les positions de rhs
+    Portfolio out = lhs;
+    out.mergeFrom(std::move(rhs));
+    return out;
+}
+
+Portfolio operator+(Portfolio&& lhs, Portfolio&& rhs) {
+    lhs.mergeFrom(std::move(rhs));
+    return std::move(lhs);
+}
+
 double Portfolio::totalValue() const {
-    double total = 0.0;
-    for (const auto& [_, pos] : positions_) total += pos.value();
-    return total;
+    return snapshot().totalValue;
 }
 
 double Portfolio::expectedReturn() const {
-    const double total = totalValue();
-    if (total <= 0.0) return 0.0;
+    const PortfolioSnapshot& s = snapshot();
+    if (s.totalValue <= 0.0) return 0.0;
 
     double er = 0.0;
-    for (const auto& [_, pos] : positions_) {
-        const double w = pos.value() / total;
-        er += w * pos.asset.expectedReturn();
-    }
+    for (std::size_t i = 0; i < s.n; ++i) er += s.weight[i] * s.mu[i];
     return er;
 }
 
 std::set<std::string> Portfolio::assetNameSet() const {
-    std::set<std::string> names;
-    for (const auto& [name, _] : positions_) names.insert(name);
-    return names;
+    const auto& order = assetOrder();
+    return std::set<std::string>(order.begin(), order.end());
 }
 
-std::vector<std::string> Portfolio::assetOrder() const {
-    std::vector<std::string> order;
-    order.reserve(positions_.size());
-    for (const auto& [name, _] : positions_) order.push_back(name);
-    return order;
+const std::vector<std::string>& Portfolio::assetOrder() const {
+    lexicalOrder();
+    return orderNames_;
 }
 
 void Portfolio::validateCorrelationMatrix(const std::vector<std::vector<double>>& corr, std::size_t n) {
@@ -132,32 +446,136 @@ void Portfolio::validateCorrelationMatrix(const std::vector<std::vector<double>>
     }
 }
 
-double Portfolio::varianceApprox(const std::vector<std::vector<double>>& corr) const {
-    const std::size_t n = positions_.size();
-    if (n == 0) return 0.0;
+// rattachement au portefeuille : taille et labels (O(n)), sans relire les coefficients
+void Portfolio::checkCorrelationBinding(const CorrelationMatrix& corr) const {
+    if (corr.size() != positions_.size()) {
+        throw std::invalid_argument("varianceApprox: correlation matrix wrong size.");
+    }
 
-    validateCorrelationMatrix(corr, n);
+    // labels optionnels : s'ils sont présents, ils doivent suivre assetOrder()
+    const auto& labels = corr.labels();
+    if (!labels.empty() && labels != assetOrder()) {
+        throw std::invalid_argument("varianceApprox: correlation labels do not match asset order.");
+    }
+}
 
-    const double total = totalValue();
-    if (total <= 0.0) return 0.0;
+double Portfolio::varianceUnchecked(const CorrelationMatrix& corr) const {
+    const PortfolioSnapshot& s = snapshot();
+    if (s.n == 0 || s.totalValue <= 0.0) return 0.0;
 
-    // map order => stable
-    std::vector<const Position*> pos;
-    pos.reserve(n);
-    for (const auto& [_, p] : positions_) pos.push_back(&p);
+    // ordre du snapshot = assetOrder
+    return sigmaScaledQuadForm(corr, s.weight.data(), s.sigma.data());
+}
 
-    std::vector<double> w(n, 0.0);
-    for (std::size_t i = 0; i < n; ++i) w[i] = pos[i]->value() / total;
+std::vector<double> Portfolio::contributionsUnchecked(const CorrelationMatrix& corr) const {
+    const PortfolioSnapshot& s = snapshot();
+    const std::size_t n = s.n;
+    std::vector<double> contributions(n, 0.0);
+    if (n == 0 || s.totalValue <= 0.0) return contributions;
+
+    std::vector<double> x(n, 0.0);
+    for (std::size_t i = 0; i < n; ++i) x[i] = s.weight[i] * s.sigma[i];
+
+    // y = C x en une passe sur le triangle supérieur (chaque c_ij lu une fois)
+    std::vector<double> y(n, 0.0);
+    symvPacked(corr.data(), x.data(), y.data(), n);
+
+    // w_i * (Sigma w)_i = x_i * (C x)_i
+    for (std::size_t i = 0; i < n; ++i) contributions[i] = x[i] * y[i];
+    return contributions;
+}
+
+RiskReport Portfolio::riskReportUnchecked(const CorrelationMatrix& corr) const {
+    const PortfolioSnapshot& s = snapshot();
+    const std::size_t n = s.n;
+
+    RiskReport r;
+    r.totalValue = s.totalValue;
+    r.weights.assign(s.weight.begin(), s.weight.end());
+    r.marginal.assign(n, 0.0);
+    r.contributions.assign(n, 0.0);
+    r.riskShares.assign(n, 0.0);
+    if (n == 0 || s.totalValue <= 0.0) return r;
+
+    std::vector<double> x(n, 0.0);
+    for (std::size_t i = 0; i < n; ++i) {
+        x[i] = s.weight[i] * s.sigma[i];
+        r.expectedReturn += s.weight[i] * s.mu[i];
+    }
+
+    // y = C x ; (Sigma w)_i = sigma_i y_i
+    std::vector<double> y(n, 0.0);
+    symvPacked(corr.data(), x.data(), y.data(), n);
 
     double var = 0.0;
     for (std::size_t i = 0; i < n; ++i) {
-        const double si = pos[i]->asset.volatility();
-        for (std::size_t j = 0; j < n; ++j) {
-            const double sj = pos[j]->asset.volatility();
-            var += w[i] * w[j] * corr[i][j] * si * sj;
-        }
+        r.contributions[i] = x[i] * y[i];
+        var += r.contributions[i];
+    }
+    r.variance = var;
+    r.volatility = std::sqrt(std::max(0.0, var));
+
+    for (std::size_t i = 0; i < n; ++i) {
+        if (r.volatility > 0.0) r.marginal[i] = s.sigma[i] * y[i] / r.volatility;
+        if (var > 0.0) r.riskShares[i] = r.contributions[i] / var;
     }
-    return var;
+    return r;
+}
+
+RiskReport Portfolio::riskReport(const ValidatedCorrelation& corr) const {
+    if (!positions_.empty()) checkCorrelationBinding(corr.matrix());
+    return riskReportUnchecked(corr.matrix());
+}
+
+RiskReport Portfolio::riskReport(const CorrelationMatrix& corr) const {
+    if (!positions_.empty()) {
+        checkCorrelationBinding(corr);
+        validateCorrelationEntries(corr, "riskReport");
+    }
+    return riskReportUnchecked(corr);
+}
+
+double Portfolio::varianceApprox(const ValidatedCorrelation& corr) const {
+    if (positions_.empty()) return 0.0;
+    checkCorrelationBinding(corr.matrix());
+    return varianceUnchecked(corr.matrix());
+}
+
+double Portfolio::volatilityApprox(const ValidatedCorrelation& corr) const {
+    const double v = varianceApprox(corr);
+    return std::sqrt(std::max(0.0, v));
+}
+
+std::vector<double> Portfolio::varianceContributionsApprox(const ValidatedCorrelation& corr) const {
+    if (positions_.empty()) return {};
+    checkCorrelationBinding(corr.matrix());
+    return contributionsUnchecked(corr.matrix());
+}
+
+double Portfolio::varianceApprox(const CorrelationMatrix& corr) const {
+    if (positions_.empty()) return 0.0;
+    checkCorrelationBinding(corr);
+    validateCorrelationEntries(corr, "varianceApprox");
+    return varianceUnchecked(corr);
+}
+
+double Portfolio::volatilityApprox(const CorrelationMatrix& corr) const {
+    const double v = varianceApprox(corr);
+    return std::sqrt(std::max(0.0, v));
+}
+
+std::vector<double> Portfolio::varianceContributionsApprox(const CorrelationMatrix& corr) const {
+    if (positions_.empty()) return {};
+    checkCorrelationBinding(corr);
+    validateCorrelationEntries(corr, "varianceApprox");
+    return contributionsUnchecked(corr);
+}
+
+// la validation pleine couvre déjà diagonale/bornes/symétrie : pas de second balayage
+double Portfolio::varianceApprox(const std::vector<std::vector<double>>& corr) const {
+    if (positions_.empty()) return 0.0;
+    validateCorrelationMatrix(corr, positions_.size());
+    return varianceUnchecked(CorrelationMatrix::fromRows(corr));
 }
 
 double Portfolio::volatilityApprox(const std::vector<std::vector<double>>& corr) const {
@@ -166,40 +584,144 @@ double Portfolio::volatilityApprox(const std::vector<std::vector<double>>& corr)
 }
 
 std::vector<double> Portfolio::varianceContributionsApprox(const std::vector<std::vector<double>>& corr) const {
-    const std::size_t n = positions_.size();
-    std::vector<double> contributions(n, 0.0);
-    if (n == 0) return contributions;
+    if (positions_.empty()) return {};
+    validateCorrelationMatrix(corr, positions_.size());
+    return contributionsUnchecked(CorrelationMatrix::fromRows(corr));
+}
 
-    validateCorrelationMatrix(corr, n);
+void Portfolio::enableRiskTracking(const CorrelationMatrix& corr, std::size_t refreshEvery) {
+    enableRiskTracking(ValidatedCorrelation(corr), refreshEvery);
+}
 
-    const double total = totalValue();
-    if (total <= 0.0) return contributions;
+void Portfolio::enableRiskTracking(const ValidatedCorrelation& corr, std::size_t refreshEvery) {
+    const auto& labels = corr.labels();
+    if (labels.size() != corr.size()) {
+        throw std::invalid_argument("enableRiskTracking: correlation matrix must be labelled.");
+    }
 
-    std::vector<const Position*> pos;
-    pos.reserve(n);
-    for (const auto& [_, p] : positions_) pos.push_back(&p);
+    RiskTracker t;
+    auto& symbols = SymbolTable::global();
+    for (std::size_t k = 0; k < labels.size(); ++k) t.index.emplace(symbols.intern(labels[k]), k);
+    for (const Position& pos : positions_) {
+        if (t.index.count(pos.id) == 0) {
+            throw std::invalid_argument("enableRiskTracking: asset not covered by correlation matrix: " + pos.asset.name());
+        }
+    }
+    t.corr = corr.shared();
+    t.refreshEvery = std::max<std::size_t>(1, refreshEvery);
+    t.stale = true;
+    tracker_ = std::move(t);
+    refreshTracker();
+}
 
-    std::vector<double> w(n, 0.0);
-    for (std::size_t i = 0; i < n; ++i) w[i] = pos[i]->value() / total;
+void Portfolio::disableRiskTracking() { tracker_.reset(); }
+
+bool Portfolio::riskTracked() const { return tracker_.has_value(); }
+
+// recalcul complet O(n^2) : z depuis les positions, y = C z, q = z . y
+void Portfolio::refreshTracker() const {
+    RiskTracker& t = *tracker_;
+    syncHoldingsTicks();
+    t.priceTicks = holdingsTicks_;
+    const std::size_t n = t.corr->size();
+    t.z.assign(n, 0.0);
+    t.y.assign(n, 0.0);
+    for (const Position& pos : positions_) t.z[t.index.at(pos.id)] = pos.asset.volatility() * pos.value();
+
+    symvPacked(t.corr->data(), t.z.data(), t.y.data(), n);
+    double q = 0.0;
+    for (std::size_t k = 0; k < n; ++k) q += t.z[k] * t.y[k];
+    t.quad = q;
+    t.updates = 0;
+    t.stale = false;
+}
 
-    for (std::size_t i = 0; i < n; ++i) {
-        const double si = pos[i]->asset.volatility();
-        double covRowDotW = 0.0;
-        for (std::size_t j = 0; j < n; ++j) {
-            const double sj = pos[j]->asset.volatility();
-            covRowDotW += corr[i][j] * si * sj * w[j];
-        }
-        contributions[i] = w[i] * covRowDotW;
+// ticks de prix partagés depuis la dernière lecture : balayage O(n) des positions,
+// mise à jour de rang 1 pour chacune dont z a bougé
+void Portfolio::syncTrackerPrices() const {
+    RiskTracker& t = *tracker_;
+    if (t.stale) {
+        refreshTracker();
+        return;
+    }
+    syncHoldingsTicks();
+    if (t.priceTicks == holdingsTicks_) return;
+    t.priceTicks = holdingsTicks_;
+    for (const Position& pos : positions_) {
+        const std::size_t k = t.index.at(pos.id);
+        applyTrackerDelta(k, pos.asset.volatility() * pos.value() - t.z[k]);
     }
+}
+
+void Portfolio::trackValueChange(AssetId id, double z) {
+    RiskTracker& t = *tracker_;
+    if (t.stale) {
+        refreshTracker();
+        return;
+    }
+    const std::size_t k = t.index.at(id);
+    applyTrackerDelta(k, z - t.z[k]);
+}
+
+// mise à jour de rang 1 : z_k += dz  =>  q += 2 dz y_k + dz^2 c_kk ; y += dz C[:,k]
+void Portfolio::applyTrackerDelta(std::size_t k, double dz) const {
+    RiskTracker& t = *tracker_;
+    if (dz == 0.0) return;
+
+    const CorrelationMatrix& c = *t.corr;
+    const std::size_t n = c.size();
+    const double* rowK = c.row(k);
+    t.quad += 2.0 * dz * t.y[k] + dz * dz * rowK[0];
+
+    // colonne k : c(j,k) pour j < k (stride décroissant), puis la ligne k contiguë
+    const double* p = c.data() + k;
+    for (std::size_t j = 0; j < k; ++j) {
+        t.y[j] += dz * *p;
+        p += n - j - 1;
+    }
+    for (std::size_t j = k; j < n; ++j) t.y[j] += dz * rowK[j - k];
+    t.z[k] += dz;
+
+    if (++t.updates >= t.refreshEvery) refreshTracker();
+}
+
+double Portfolio::trackedVariance() const {
+    if (!tracker_) throw std::logic_error("trackedVariance: risk tracking is not enabled.");
+    syncTrackerPrices();
+
+    const double total = totalValue();
+    if (total <= 0.0) return 0.0;
+    return tracker_->quad / (total * total);
+}
+
+double Portfolio::trackedVolatility() const {
+    return std::sqrt(std::max(0.0, trackedVariance()));
+}
+
+std::vector<double> Portfolio::trackedContributions() const {
+    if (!tracker_) throw std::logic_error("trackedContributions: risk tracking is not enabled.");
+    syncTrackerPrices();
 
+    std::vector<double> contributions(positions_.size(), 0.0);
+    const double total = totalValue();
+    if (total <= 0.0) return contributions;
+
+    // w_i (Sigma w)_i = z_i y_i / V^2
+    const double inv = 1.0 / (total * total);
+    std::size_t i = 0;
+    for (std::uint32_t slot : lexicalOrder()) {
+        const std::size_t k = tracker_->index.at(positions_[slot].id);
+        contributions[i++] = tracker_->z[k] * tracker_->y[k] * inv;
+    }
     return contributions;
 }
 
 void Portfolio::display() const {
     std::cout << "Asset order for corr matrix:\n";
     std::size_t k = 0;
-    for (const auto& [name, pos] : positions_) {
-        std::cout << "  [" << k++ << "] " << name
+    for (std::uint32_t slot : lexicalOrder()) {
+        const Position& pos = positions_[slot];
+        std::cout << "  [" << k++ << "] " << pos.asset.name()
                   << " | qty=" << pos.quantity
                   << " | price=" << pos.asset.price()
                   << " | mu=" << pos.asset.expectedReturn()
@@ -212,14 +734,14 @@ void Portfolio::display() const {
 }
 
 void Portfolio::printWeights() const {
-    const double total = totalValue();
-    if (total <= 0.0) {
+    const PortfolioSnapshot& s = snapshot();
+    if (s.totalValue <= 0.0) {
         std::cout << "Weights: portfolio is empty.\n";
         return;
     }
     std::cout << "Weights:\n";
-    for (const auto& [name, pos] : positions_) {
-        const double w = pos.value() / total;
-        std::cout << "  " << name << " : " << w << "\n";
+    const auto& names = assetOrder();
+    for (std::size_t i = 0; i < s.n; ++i) {
+        std::cout << "  " << names[i] << " : " << s.weight[i] << "\n";
     }
 }
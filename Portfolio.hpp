@@ -2,47 +2,197 @@
 #define PORTFOLIO_HPP
 
 #include "Asset.hpp"
-#include <map>
+#include "CorrelationMatrix.hpp"
+#include "SymbolTable.hpp"
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+// La position référence l'actif (poignée partagée), elle n'en possède pas de copie
 struct Position {
     Asset asset;
     double quantity;
+    AssetId id;   // = asset.id()
 
     Position(const Asset& a, double q);
     double value() const;
 };
 
+// Vue "structure of arrays" du portefeuille, dans l'ordre de assetOrder().
+// Reconstruite au plus une fois par version d'état ; les noyaux de risque
+// et l'optimiseur lisent ces tableaux contigus au lieu de parcourir les positions.
+struct PortfolioSnapshot {
+    std::size_t n = 0;
+    double totalValue = 0.0;
+    AlignedDoubles mu;
+    AlignedDoubles sigma;
+    AlignedDoubles price;
+    AlignedDoubles qty;
+    AlignedDoubles value;
+    AlignedDoubles weight;   // 0 si totalValue <= 0
+};
+
+// Rapport de risque calculé en une passe (Sigma w une seule fois), ordre assetOrder().
+struct RiskReport {
+    double totalValue = 0.0;
+    double expectedReturn = 0.0;
+    double variance = 0.0;
+    double volatility = 0.0;
+    std::vector<double> weights;
+    std::vector<double> marginal;       // d(vol)/d(w_i) = (Sigma w)_i / vol
+    std::vector<double> contributions;  // w_i (Sigma w)_i, somme = variance
+    std::vector<double> riskShares;     // contributions / variance (0 si variance nulle)
+};
+
+// Tick de prix (ticker interné via SymbolTable::global().intern)
+struct PriceTick {
+    AssetId id;
+    double price;
+};
+
 class Portfolio {
 private:
-    // ordre stable (tri lexical) => corr matrix reproductible
-    std::map<std::string, Position> positions_;
+    // stockage plat (ordre d'insertion, retrait par swap) + index AssetId -> slot
+    std::vector<Position> positions_;
+    std::unordered_map<AssetId, std::uint32_t> slotOf_;
+
+    // ordre stable (tri lexical) => corr matrix reproductible ; permutation des slots
+    // mise en cache, recalculée seulement après insertion/suppression
+    mutable std::vector<std::uint32_t> lexOrder_;
+    mutable std::vector<std::uint32_t> rankOf_;   // slot -> rang dans lexOrder_
+    mutable std::vector<std::string> orderNames_;
+    mutable std::uint64_t orderVersion_ = ~std::uint64_t(0);
+    std::uint64_t structureVersion_ = 0;
+
+    // incrémentée à chaque mutation (et à chaque accès non-const)
+    std::uint64_t version_ = 0;
+    mutable PortfolioSnapshot snapshot_;
+    mutable std::uint64_t snapshotVersion_ = ~std::uint64_t(0);
+    mutable std::uint64_t snapshotTicks_ = ~std::uint64_t(0);   // holdingsTicks_ au dernier calcul
+
+    // écritures partagées sur les actifs détenus, détectées paresseusement : un tick
+    // sur un actif absent du portefeuille n'invalide ni version() ni les caches
+    mutable std::uint64_t holdingsTicks_ = 0;
+    mutable std::uint64_t holdingsEpoch_ = 0;   // assetPriceEpoch() au dernier contrôle
+
+    // Mode "risk-tracked" : on maintient y = C z et q = z' C z (z_k = sigma_k * valeur_k,
+    // ordre de l'univers de la matrice) à chaque mutation, en O(n) au lieu de O(n^2).
+    struct RiskTracker {
+        std::shared_ptr<const CorrelationMatrix> corr;
+        std::unordered_map<AssetId, std::size_t> index;  // AssetId du label -> indice univers
+        std::vector<double> z;
+        std::vector<double> y;
+        double quad = 0.0;
+        std::size_t refreshEvery = 1024;
+        std::size_t updates = 0;
+        bool stale = false;   // accès non-const : recalcul complet à la prochaine lecture
+        std::uint64_t priceTicks = 0;   // holdingsTicks_ déjà intégrés
+    };
+    mutable std::optional<RiskTracker> tracker_;
+
+    void trackValueChange(AssetId id, double z);   // z = sigma * valeur après mutation
+    void applyTrackerDelta(std::size_t k, double dz) const;
+    void syncTrackerPrices() const;
+    void syncHoldingsTicks() const;
+    void refreshTracker() const;
+
+    Position* findSlot(const std::string& assetName);
+    const std::vector<std::uint32_t>& lexicalOrder() const;
+    void eraseSlot(std::uint32_t slot);
+    void checkMergeable(const Portfolio& other) const;
+    template <typename Source> void mergePositions(Source&& other);
 
     static void validateCorrelationMatrix(const std::vector<std::vector<double>>& corr, std::size_t n);
+    void checkCorrelationBinding(const CorrelationMatrix& corr) const;
+    double varianceUnchecked(const CorrelationMatrix& corr) const;
+    std::vector<double> contributionsUnchecked(const CorrelationMatrix& corr) const;
+    RiskReport riskReportUnchecked(const CorrelationMatrix& corr) const;
 
 public:
     void addPosition(const Asset& a, double quantity);
     void removePosition(const std::string& assetName, double quantity);
+    // prix propre à ce portefeuille (actif détaché) ; tick global : AssetRegistry::setPrice
+    void setPrice(const std::string& assetName, double price);
+    // nouveau fetch d'un actif détenu (prix, mu, sigma) : la position pointe sur a, les
+    // autres détenteurs de l'ancien enregistrement ne voient rien ; out_of_range si absent
+    void replaceAsset(const Asset& a);
+    // Lot de ticks (prix locaux, comme setPrice) : le dernier tick d'un actif l'emporte,
+    // les actifs non détenus sont ignorés. Snapshot (total, poids) patché sur place,
+    // risk-tracker mis à jour par rang 1. Renvoie les actifs dont le prix a changé.
+    std::vector<AssetId> applyPrices(const PriceTick* ticks, std::size_t count);
+    std::vector<AssetId> applyPrices(const std::vector<PriceTick>& ticks);
     void printWeights() const;
 
     Position& operator[](const std::string& assetName);
     const Position& operator[](const std::string& assetName) const;
 
+    // accès O(1) sans comparaison de chaînes ; nullptr si absent
+    const Position* find(AssetId id) const;
+    const Position* find(const std::string& assetName) const;
+    // k-ième position dans l'ordre assetOrder()
+    const Position& positionAt(std::size_t k) const;
+
+    // Fusion en une passe O(m) (index hash), sans copie de lhs pour les rvalues.
+    // Pas de fusion de maps triées ni de réemploi de nœuds : le stockage est plat
+    // (positions_ + slotOf_), chaque ticker de other est un lookup O(1).
+    // Même ticker : quantités additionnées, prix de *this conservé ; mu/sigma
+    // incohérents => invalid_argument et aucune modification.
+    void mergeFrom(const Portfolio& other);
+    void mergeFrom(Portfolio&& other);   // déplace les positions ; other est vidé
+    // consolidation de n sous-portefeuilles (capacité réservée une seule fois)
+    static Portfolio mergeAll(const std::vector<Portfolio>& parts);
+    static Portfolio mergeAll(std::vector<Portfolio>&& parts);
+
     friend Portfolio operator+(const Portfolio& lhs, const Portfolio& rhs);
+    friend Portfolio operator+(Portfolio&& lhs, const Portfolio& rhs);
+    friend Portfolio operator+(const Portfolio& lhs, Portfolio&& rhs);
+    friend Portfolio operator+(Portfolio&& lhs, Portfolio&& rhs);
 
     std::size_t size() const;
+    // change à chaque mutation locale et à chaque tick partagé sur un actif détenu
+    std::uint64_t version() const;
+    const PortfolioSnapshot& snapshot() const;
+
     double totalValue() const;
     double expectedReturn() const;
 
+    // poignée validée : seuls taille et labels sont vérifiés (pas de re-balayage O(n^2))
+    double varianceApprox(const ValidatedCorrelation& corr) const;
+    double volatilityApprox(const ValidatedCorrelation& corr) const;
+    std::vector<double> varianceContributionsApprox(const ValidatedCorrelation& corr) const;
+
+    double varianceApprox(const CorrelationMatrix& corr) const;
+    double volatilityApprox(const CorrelationMatrix& corr) const;
+    std::vector<double> varianceContributionsApprox(const CorrelationMatrix& corr) const;
+
+    // compatibilité : matrice pleine, validée puis compactée
     double varianceApprox(const std::vector<std::vector<double>>& corr) const;
     double volatilityApprox(const std::vector<std::vector<double>>& corr) const;
     std::vector<double> varianceContributionsApprox(const std::vector<std::vector<double>>& corr) const;
-    
+
+    // ER, variance, vol, marginales et parts de risque en une seule passe O(n^2)
+    RiskReport riskReport(const ValidatedCorrelation& corr) const;
+    RiskReport riskReport(const CorrelationMatrix& corr) const;
+
+    // Mode risk-tracked : corr doit être labellisée et couvrir toutes les positions.
+    // Un ajout hors univers fait sortir du mode ; recalcul complet toutes les
+    // refreshEvery mises à jour pour borner la dérive numérique.
+    void enableRiskTracking(const ValidatedCorrelation& corr, std::size_t refreshEvery = 1024);
+    void enableRiskTracking(const CorrelationMatrix& corr, std::size_t refreshEvery = 1024);
+    void disableRiskTracking();
+    bool riskTracked() const;
+    double trackedVariance() const;
+    double trackedVolatility() const;
+    std::vector<double> trackedContributions() const;   // ordre assetOrder()
+
     // pour construire la matrice dans le bon ordre
     std::set<std::string> assetNameSet() const;
-    std::vector<std::string> assetOrder() const;
+    // noms triés, mis en cache (référence invalidée par la prochaine insertion/suppression)
+    const std::vector<std::string>& assetOrder() const;
     void display() const;
 };
 
@@ -0,0 +1,115 @@
+#include "PriceHistory.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+// annualize (252 trading days)
+static void annualize(PriceHistory& h) {
+    h.mu = h.returnStats.mean() * 252.0;
+    h.sigma = h.returnStats.stddev() * std::sqrt(252.0);
+}
+
+PriceHistory PriceHistory::fromCloses(std::string ticker, std::vector<std::int64_t> timestamps,
+                                      std::vector<double> closes) {
+    if (timestamps.size() != closes.size()) {
+        throw std::invalid_argument("PriceHistory::fromCloses: timestamps/closes size mismatch.");
+    }
+    if (closes.size() < 30) {
+        throw std::runtime_error("Not enough close prices returned by Yahoo (need ~30+).");
+    }
+
+    PriceHistory h;
+    h.ticker = std::move(ticker);
+    h.timestamps = std::move(timestamps);
+    h.closes = std::move(closes);
+
+    const std::size_t n = h.closes.size();
+    h.logReturns.reserve(n - 1);
+    h.returnTimestamps.reserve(n - 1);
+    for (std::size_t i = 1; i < n; ++i) {
+        if (h.closes[i-1] <= 0.0 || h.closes[i] <= 0.0) continue;
+        const double x = std::log(h.closes[i] / h.closes[i-1]);
+        h.logReturns.push_back(x);
+        h.returnTimestamps.push_back(h.timestamps[i]);
+        h.returnStats.add(x);
+    }
+    if (h.logReturns.size() < 20) throw std::runtime_error("Not enough valid returns to compute stats.");
+
+    h.lastPrice = h.closes.back();
+    annualize(h);
+    return h;
+}
+
+void PriceHistory::appendBars(const std::vector<std::int64_t>& newTimestamps, const std::vector<double>& newCloses,
+                              std::int64_t windowSeconds) {
+    if (newTimestamps.size() != newCloses.size()) {
+        throw std::invalid_argument("PriceHistory::appendBars: timestamps/closes size mismatch.");
+    }
+    if (newTimestamps.empty()) return;
+    for (std::size_t i = 1; i < newTimestamps.size(); ++i) {
+        if (newTimestamps[i] <= newTimestamps[i-1]) {
+            throw std::invalid_argument("PriceHistory::appendBars: timestamps must be increasing.");
+        }
+    }
+
+    // travail sur copie : *this reste intact si l'historique devient trop court
+    PriceHistory h = *this;
+
+    // barres révisées (ou recouvertes) : retirées par la fin avec leur rendement
+    while (!h.timestamps.empty() && h.timestamps.back() >= newTimestamps.front()) {
+        if (!h.returnTimestamps.empty() && h.returnTimestamps.back() == h.timestamps.back()) {
+            h.returnStats.remove(h.logReturns.back());
+            ++h.statsRemovals;
+            h.logReturns.pop_back();
+            h.returnTimestamps.pop_back();
+        }
+        h.timestamps.pop_back();
+        h.closes.pop_back();
+    }
+
+    for (std::size_t i = 0; i < newCloses.size(); ++i) {
+        const double c = newCloses[i];
+        if (!h.closes.empty() && h.closes.back() > 0.0 && c > 0.0) {
+            const double x = std::log(c / h.closes.back());
+            h.logReturns.push_back(x);
+            h.returnTimestamps.push_back(newTimestamps[i]);
+            h.returnStats.add(x);
+        }
+        h.timestamps.push_back(newTimestamps[i]);
+        h.closes.push_back(c);
+    }
+
+    // fenêtre glissante : barres trop anciennes, puis rendements dont le close de départ est parti
+    if (windowSeconds > 0) {
+        const std::int64_t cutoff = h.timestamps.back() - windowSeconds;
+        const std::size_t bars = std::lower_bound(h.timestamps.begin(), h.timestamps.end(), cutoff) - h.timestamps.begin();
+        if (bars > 0) {
+            h.timestamps.erase(h.timestamps.begin(), h.timestamps.begin() + (long long)bars);
+            h.closes.erase(h.closes.begin(), h.closes.begin() + (long long)bars);
+            std::size_t returns = 0;
+            while (returns < h.returnTimestamps.size() && h.returnTimestamps[returns] <= h.timestamps.front()) {
+                h.returnStats.remove(h.logReturns[returns]);
+                ++h.statsRemovals;
+                ++returns;
+            }
+            h.logReturns.erase(h.logReturns.begin(), h.logReturns.begin() + (long long)returns);
+            h.returnTimestamps.erase(h.returnTimestamps.begin(), h.returnTimestamps.begin() + (long long)returns);
+        }
+    }
+
+    if (h.logReturns.size() < 20) throw std::runtime_error("Not enough valid returns to compute stats.");
+    if (h.statsRemovals >= kStatsRefreshEvery) {
+        // ré-ancrage : les retraits successifs ne font plus dériver mu/sigma
+        h.returnStats.clear();
+        for (double x : h.logReturns) h.returnStats.add(x);
+        h.statsRemovals = 0;
+    }
+    h.lastPrice = h.closes.back();
+    annualize(h);
+    *this = std::move(h);
+}
+
+Asset PriceHistory::toAsset() const {
+    return Asset(ticker, lastPrice, mu, sigma);
+}
@@ -0,0 +1,43 @@
+#ifndef PRICE_HISTORY_HPP
+#define PRICE_HISTORY_HPP
+
+#include "Asset.hpp"
+#include "OnlineStats.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Historique journalier d'un ticker, obtenu en une seule requête chart : tout ce
+// dont Asset (prix, mu, sigma) et la corrélation (log-returns) ont besoin.
+struct PriceHistory {
+    std::string ticker;
+    std::vector<std::int64_t> timestamps;        // secondes Unix, alignés sur closes
+    std::vector<double> closes;                  // closes null exclus
+    std::vector<double> logReturns;              // log(c_i / c_{i-1}), paires > 0 seulement
+    std::vector<std::int64_t> returnTimestamps;  // date de fin de chaque rendement
+    double lastPrice = 0.0;
+    double mu = 0.0;      // annualisé (252 jours)
+    double sigma = 0.0;   // annualisé (252 jours)
+    RunningStats returnStats;   // Welford sur logReturns : mu/sigma suivent les ajouts sans recalcul complet
+    std::size_t statsRemovals = 0;   // retraits de returnStats depuis son dernier recalcul complet
+
+    // retraits de Welford entre deux recalculs complets de returnStats (dérive numérique bornée)
+    static constexpr std::size_t kStatsRefreshEvery = 1024;
+
+    // Calcule rendements et statistiques ; runtime_error si l'historique est trop court
+    static PriceHistory fromCloses(std::string ticker, std::vector<std::int64_t> timestamps,
+                                   std::vector<double> closes);
+
+    // Ajoute des barres (timestamps croissants). Les barres existantes à partir du
+    // premier nouveau timestamp sont remplacées (dernier close révisé), puis la fenêtre
+    // est ramenée à windowSeconds avant la dernière barre (0 = pas de limite).
+    // Rendements, returnStats et mu/sigma sont mis à jour barre par barre ; returnStats
+    // est recalculé de zéro toutes les kStatsRefreshEvery retraits.
+    void appendBars(const std::vector<std::int64_t>& newTimestamps, const std::vector<double>& newCloses,
+                    std::int64_t windowSeconds = 0);
+
+    Asset toAsset() const;
+};
+
+#endif
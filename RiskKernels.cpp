@@ -0,0 +1,349 @@
+#include "RiskKernels.hpp"
+#include <atomic>
+#include <vector>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define RISK_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// primitives par ligne : dot(a, b) et dot + axpy fusionnés (y += row * xi)
+using DotFn = double (*)(const double*, const double*, std::size_t);
+using DotAxpyFn = double (*)(const double*, const double*, double*, double, std::size_t);
+// tuile 4 x 2 de produits scalaires entre colonnes (X'X) : 8 accumulateurs, 6 chargements par pas
+using GramTileFn = void (*)(const double* const*, const double* const*, std::size_t, double*);
+
+struct KernelTable {
+    KernelIsa isa;
+    DotFn dot;
+    DotAxpyFn dotAxpy;
+    GramTileFn gramTile;
+};
+
+double dotScalar(const double* a, const double* b, std::size_t len) {
+    double s = 0.0;
+    for (std::size_t k = 0; k < len; ++k) s += a[k] * b[k];
+    return s;
+}
+
+double dotAxpyScalar(const double* row, const double* x, double* y, double xi, std::size_t len) {
+    double s = 0.0;
+    for (std::size_t k = 0; k < len; ++k) {
+        s += row[k] * x[k];
+        y[k] += row[k] * xi;
+    }
+    return s;
+}
+
+void gramTileScalar(const double* const* a, const double* const* b, std::size_t len, double* out) {
+    double acc[8] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    for (std::size_t k = 0; k < len; ++k) {
+        const double b0 = b[0][k];
+        const double b1 = b[1][k];
+        for (int r = 0; r < 4; ++r) {
+            acc[2 * r] += a[r][k] * b0;
+            acc[2 * r + 1] += a[r][k] * b1;
+        }
+    }
+    for (int t = 0; t < 8; ++t) out[t] = acc[t];
+}
+
+#ifdef RISK_KERNELS_X86
+
+__attribute__((target("sse2")))
+double dotSSE2(const double* a, const double* b, std::size_t len) {
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+    std::size_t k = 0;
+    for (; k + 4 <= len; k += 4) {
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(a + k), _mm_loadu_pd(b + k)));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(a + k + 2), _mm_loadu_pd(b + k + 2)));
+    }
+    acc0 = _mm_add_pd(acc0, acc1);
+    double tmp[2];
+    _mm_storeu_pd(tmp, acc0);
+    double s = tmp[0] + tmp[1];
+    for (; k < len; ++k) s += a[k] * b[k];
+    return s;
+}
+
+__attribute__((target("sse2")))
+double dotAxpySSE2(const double* row, const double* x, double* y, double xi, std::size_t len) {
+    const __m128d vxi = _mm_set1_pd(xi);
+    __m128d acc = _mm_setzero_pd();
+    std::size_t k = 0;
+    for (; k + 2 <= len; k += 2) {
+        const __m128d r = _mm_loadu_pd(row + k);
+        acc = _mm_add_pd(acc, _mm_mul_pd(r, _mm_loadu_pd(x + k)));
+        _mm_storeu_pd(y + k, _mm_add_pd(_mm_loadu_pd(y + k), _mm_mul_pd(r, vxi)));
+    }
+    double tmp[2];
+    _mm_storeu_pd(tmp, acc);
+    double s = tmp[0] + tmp[1];
+    for (; k < len; ++k) {
+        s += row[k] * x[k];
+        y[k] += row[k] * xi;
+    }
+    return s;
+}
+
+__attribute__((target("sse2")))
+void gramTileSSE2(const double* const* a, const double* const* b, std::size_t len, double* out) {
+    __m128d acc[8];
+    for (int t = 0; t < 8; ++t) acc[t] = _mm_setzero_pd();
+    std::size_t k = 0;
+    for (; k + 2 <= len; k += 2) {
+        const __m128d b0 = _mm_loadu_pd(b[0] + k);
+        const __m128d b1 = _mm_loadu_pd(b[1] + k);
+        for (int r = 0; r < 4; ++r) {
+            const __m128d ar = _mm_loadu_pd(a[r] + k);
+            acc[2 * r] = _mm_add_pd(acc[2 * r], _mm_mul_pd(ar, b0));
+            acc[2 * r + 1] = _mm_add_pd(acc[2 * r + 1], _mm_mul_pd(ar, b1));
+        }
+    }
+    for (int t = 0; t < 8; ++t) {
+        double tmp[2];
+        _mm_storeu_pd(tmp, acc[t]);
+        out[t] = tmp[0] + tmp[1];
+    }
+    for (; k < len; ++k) {
+        for (int r = 0; r < 4; ++r) {
+            out[2 * r] += a[r][k] * b[0][k];
+            out[2 * r + 1] += a[r][k] * b[1][k];
+        }
+    }
+}
+
+__attribute__((target("avx2,fma")))
+double dotAVX2(const double* a, const double* b, std::size_t len) {
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    std::size_t k = 0;
+    for (; k + 8 <= len; k += 8) {
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + k), _mm256_loadu_pd(b + k), acc0);
+        acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + k + 4), _mm256_loadu_pd(b + k + 4), acc1);
+    }
+    for (; k + 4 <= len; k += 4) {
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + k), _mm256_loadu_pd(b + k), acc0);
+    }
+    acc0 = _mm256_add_pd(acc0, acc1);
+    alignas(32) double tmp[4];
+    _mm256_store_pd(tmp, acc0);
+    double s = (tmp[0] + tmp[1]) + (tmp[2] + tmp[3]);
+    for (; k < len; ++k) s += a[k] * b[k];
+    return s;
+}
+
+__attribute__((target("avx2,fma")))
+double dotAxpyAVX2(const double* row, const double* x, double* y, double xi, std::size_t len) {
+    const __m256d vxi = _mm256_set1_pd(xi);
+    __m256d acc = _mm256_setzero_pd();
+    std::size_t k = 0;
+    for (; k + 4 <= len; k += 4) {
+        const __m256d r = _mm256_loadu_pd(row + k);
+        acc = _mm256_fmadd_pd(r, _mm256_loadu_pd(x + k), acc);
+        _mm256_storeu_pd(y + k, _mm256_fmadd_pd(r, vxi, _mm256_loadu_pd(y + k)));
+    }
+    alignas(32) double tmp[4];
+    _mm256_store_pd(tmp, acc);
+    double s = (tmp[0] + tmp[1]) + (tmp[2] + tmp[3]);
+    for (; k < len; ++k) {
+        s += row[k] * x[k];
+        y[k] += row[k] * xi;
+    }
+    return s;
+}
+
+__attribute__((target("avx2,fma")))
+void gramTileAVX2(const double* const* a, const double* const* b, std::size_t len, double* out) {
+    __m256d acc[8];
+    for (int t = 0; t < 8; ++t) acc[t] = _mm256_setzero_pd();
+    std::size_t k = 0;
+    for (; k + 4 <= len; k += 4) {
+        const __m256d b0 = _mm256_loadu_pd(b[0] + k);
+        const __m256d b1 = _mm256_loadu_pd(b[1] + k);
+        for (int r = 0; r < 4; ++r) {
+            const __m256d ar = _mm256_loadu_pd(a[r] + k);
+            acc[2 * r] = _mm256_fmadd_pd(ar, b0, acc[2 * r]);
+            acc[2 * r + 1] = _mm256_fmadd_pd(ar, b1, acc[2 * r + 1]);
+        }
+    }
+    for (int t = 0; t < 8; ++t) {
+        alignas(32) double tmp[4];
+        _mm256_store_pd(tmp, acc[t]);
+        out[t] = (tmp[0] + tmp[1]) + (tmp[2] + tmp[3]);
+    }
+    for (; k < len; ++k) {
+        for (int r = 0; r < 4; ++r) {
+            out[2 * r] += a[r][k] * b[0][k];
+            out[2 * r + 1] += a[r][k] * b[1][k];
+        }
+    }
+}
+
+__attribute__((target("avx512f")))
+inline double hsum512(__m512d v) {
+    alignas(64) double tmp[8];
+    _mm512_store_pd(tmp, v);
+    return ((tmp[0] + tmp[1]) + (tmp[2] + tmp[3])) + ((tmp[4] + tmp[5]) + (tmp[6] + tmp[7]));
+}
+
+__attribute__((target("avx512f")))
+double dotAVX512(const double* a, const double* b, std::size_t len) {
+    __m512d acc0 = _mm512_setzero_pd();
+    __m512d acc1 = _mm512_setzero_pd();
+    std::size_t k = 0;
+    for (; k + 16 <= len; k += 16) {
+        acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + k), _mm512_loadu_pd(b + k), acc0);
+        acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(a + k + 8), _mm512_loadu_pd(b + k + 8), acc1);
+    }
+    if (k < len) {
+        // reste masqué : pas de boucle scalaire
+        const __mmask8 m = static_cast<__mmask8>((len - k) >= 8 ? 0xFF : ((1u << (len - k)) - 1u));
+        acc0 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(m, a + k), _mm512_maskz_loadu_pd(m, b + k), acc0);
+        k += (len - k) >= 8 ? 8 : (len - k);
+    }
+    if (k < len) {
+        const __mmask8 m = static_cast<__mmask8>((1u << (len - k)) - 1u);
+        acc1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(m, a + k), _mm512_maskz_loadu_pd(m, b + k), acc1);
+    }
+    return hsum512(_mm512_add_pd(acc0, acc1));
+}
+
+__attribute__((target("avx512f")))
+double dotAxpyAVX512(const double* row, const double* x, double* y, double xi, std::size_t len) {
+    const __m512d vxi = _mm512_set1_pd(xi);
+    __m512d acc = _mm512_setzero_pd();
+    std::size_t k = 0;
+    for (; k + 8 <= len; k += 8) {
+        const __m512d r = _mm512_loadu_pd(row + k);
+        acc = _mm512_fmadd_pd(r, _mm512_loadu_pd(x + k), acc);
+        _mm512_storeu_pd(y + k, _mm512_fmadd_pd(r, vxi, _mm512_loadu_pd(y + k)));
+    }
+    if (k < len) {
+        const __mmask8 m = static_cast<__mmask8>((1u << (len - k)) - 1u);
+        const __m512d r = _mm512_maskz_loadu_pd(m, row + k);
+        acc = _mm512_fmadd_pd(r, _mm512_maskz_loadu_pd(m, x + k), acc);
+        _mm512_mask_storeu_pd(y + k, m, _mm512_fmadd_pd(r, vxi, _mm512_maskz_loadu_pd(m, y + k)));
+    }
+    return hsum512(acc);
+}
+
+__attribute__((target("avx512f")))
+void gramTileAVX512(const double* const* a, const double* const* b, std::size_t len, double* out) {
+    __m512d acc[8];
+    for (int t = 0; t < 8; ++t) acc[t] = _mm512_setzero_pd();
+    std::size_t k = 0;
+    for (; k < len; k += 8) {
+        const __mmask8 m = static_cast<__mmask8>((len - k) >= 8 ? 0xFF : ((1u << (len - k)) - 1u));
+        const __m512d b0 = _mm512_maskz_loadu_pd(m, b[0] + k);
+        const __m512d b1 = _mm512_maskz_loadu_pd(m, b[1] + k);
+        for (int r = 0; r < 4; ++r) {
+            const __m512d ar = _mm512_maskz_loadu_pd(m, a[r] + k);
+            acc[2 * r] = _mm512_fmadd_pd(ar, b0, acc[2 * r]);
+            acc[2 * r + 1] = _mm512_fmadd_pd(ar, b1, acc[2 * r + 1]);
+        }
+    }
+    for (int t = 0; t < 8; ++t) out[t] = hsum512(acc[t]);
+}
+
+#endif
+
+const KernelTable kScalar{KernelIsa::Scalar, dotScalar, dotAxpyScalar, gramTileScalar};
+#ifdef RISK_KERNELS_X86
+const KernelTable kSSE2{KernelIsa::SSE2, dotSSE2, dotAxpySSE2, gramTileSSE2};
+const KernelTable kAVX2{KernelIsa::AVX2, dotAVX2, dotAxpyAVX2, gramTileAVX2};
+const KernelTable kAVX512{KernelIsa::AVX512, dotAVX512, dotAxpyAVX512, gramTileAVX512};
+#endif
+
+const KernelTable* tableFor(KernelIsa isa) {
+    switch (isa) {
+#ifdef RISK_KERNELS_X86
+        case KernelIsa::SSE2: return &kSSE2;
+        case KernelIsa::AVX2: return &kAVX2;
+        case KernelIsa::AVX512: return &kAVX512;
+#endif
+        default: return &kScalar;
+    }
+}
+
+const KernelTable* detectBest() {
+    if (kernelIsaSupported(KernelIsa::AVX512)) return tableFor(KernelIsa::AVX512);
+    if (kernelIsaSupported(KernelIsa::AVX2)) return tableFor(KernelIsa::AVX2);
+    if (kernelIsaSupported(KernelIsa::SSE2)) return tableFor(KernelIsa::SSE2);
+    return &kScalar;
+}
+
+std::atomic<const KernelTable*>& activeTable() {
+    static std::atomic<const KernelTable*> table{detectBest()};
+    return table;
+}
+
+} // namespace
+
+bool kernelIsaSupported(KernelIsa isa) {
+    switch (isa) {
+        case KernelIsa::Scalar: return true;
+#ifdef RISK_KERNELS_X86
+        case KernelIsa::SSE2: return __builtin_cpu_supports("sse2");
+        case KernelIsa::AVX2: return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        case KernelIsa::AVX512: return __builtin_cpu_supports("avx512f");
+#endif
+        default: return false;
+    }
+}
+
+KernelIsa activeKernelIsa() { return activeTable().load(std::memory_order_relaxed)->isa; }
+
+const char* kernelIsaName(KernelIsa isa) {
+    switch (isa) {
+        case KernelIsa::SSE2: return "sse2";
+        case KernelIsa::AVX2: return "avx2";
+        case KernelIsa::AVX512: return "avx512";
+        default: return "scalar";
+    }
+}
+
+bool setKernelIsa(KernelIsa isa) {
+    if (!kernelIsaSupported(isa)) return false;
+    activeTable().store(tableFor(isa), std::memory_order_relaxed);
+    return true;
+}
+
+double quadFormPacked(const double* packed, const double* x, std::size_t n) {
+    const KernelTable* t = activeTable().load(std::memory_order_relaxed);
+    // x' C x = sum_i x_i * (c_ii x_i + 2 sum_{j>i} c_ij x_j)
+    double q = 0.0;
+    const double* row = packed;
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::size_t len = n - i - 1;
+        q += x[i] * (row[0] * x[i] + 2.0 * t->dot(row + 1, x + i + 1, len));
+        row += len + 1;
+    }
+    return q;
+}
+
+void symvPacked(const double* packed, const double* x, double* y, std::size_t n) {
+    const KernelTable* t = activeTable().load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < n; ++i) y[i] = 0.0;
+
+    const double* row = packed;
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::size_t len = n - i - 1;
+        y[i] += row[0] * x[i] + t->dotAxpy(row + 1, x + i + 1, y + i + 1, x[i], len);
+        row += len + 1;
+    }
+}
+
+double sigmaScaledQuadForm(const CorrelationMatrix& corr, const double* w, const double* sigma) {
+    const std::size_t n = corr.size();
+    std::vector<double> x(n, 0.0);
+    for (std::size_t i = 0; i < n; ++i) x[i] = w[i] * sigma[i];
+    return quadFormPacked(corr.data(), x.data(), n);
+}
+
+void gramTile4x2(const double* const* a, const double* const* b, std::size_t len, double* out) {
+    activeTable().load(std::memory_order_relaxed)->gramTile(a, b, len, out);
+}
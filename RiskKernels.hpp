@@ -0,0 +1,30 @@
+#ifndef RISK_KERNELS_HPP
+#define RISK_KERNELS_HPP
+
+#include "CorrelationMatrix.hpp"
+#include <cstddef>
+
+// Noyaux de forme quadratique sur matrice symétrique compactée (triangle supérieur)
+// et tuile du produit X'X (moteur de covariance).
+// Variantes scalar / SSE2 / AVX2 / AVX-512 ; la meilleure est choisie au démarrage (CPUID).
+enum class KernelIsa { Scalar, SSE2, AVX2, AVX512 };
+
+// x' C x en n'utilisant que le triangle supérieur (moitié des flops)
+double quadFormPacked(const double* packed, const double* x, std::size_t n);
+
+// y = C x (y écrasé) ; une seule lecture de chaque c_ij
+void symvPacked(const double* packed, const double* x, double* y, std::size_t n);
+
+// x_i = w_i * sigma_i puis x' C x : variance du portefeuille
+double sigmaScaledQuadForm(const CorrelationMatrix& corr, const double* w, const double* sigma);
+
+// Tuile de X'X sur colonnes contiguës : out[2r + c] = a[r] . b[c], r < 4, c < 2
+void gramTile4x2(const double* const* a, const double* const* b, std::size_t len, double* out);
+
+KernelIsa activeKernelIsa();
+const char* kernelIsaName(KernelIsa isa);
+bool kernelIsaSupported(KernelIsa isa);
+// force une variante (tests / bench) ; false si le CPU ne la supporte pas
+bool setKernelIsa(KernelIsa isa);
+
+#endif
@@ -0,0 +1,93 @@
+#include "RollingCorrelation.hpp"
+#include "OnlineStats.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+RollingCorrelationSeries RollingCorrelationSeries::compute(const AlignedReturns& aligned,
+                                                           const RollingCorrelationOptions& options) {
+    if (aligned.missing() != MissingReturns::Intersection) {
+        throw std::invalid_argument("RollingCorrelationSeries::compute: requires Intersection alignment (no gaps).");
+    }
+    if (options.window < 2) throw std::invalid_argument("RollingCorrelationSeries::compute: window must be >= 2.");
+    if (options.step == 0) throw std::invalid_argument("RollingCorrelationSeries::compute: step must be > 0.");
+    if (options.refreshEvery == 0) {
+        throw std::invalid_argument("RollingCorrelationSeries::compute: refreshEvery must be > 0.");
+    }
+
+    const std::size_t n = aligned.series();
+    const std::size_t T = aligned.rows();
+    const std::size_t W = options.window;
+    const std::size_t steps = T < W ? 0 : (T - W) / options.step + 1;
+
+    RollingCorrelationSeries out;
+    out.labels_ = aligned.labels();
+    out.window_ = W;
+    out.timestamps_.reserve(steps);
+    out.values_.assign(n * (n - 1) / 2 * steps, 0.0f);
+    if (steps == 0) return out;
+
+    RunningCovariance cov(n);
+    std::vector<double> sd(n);
+    std::size_t slides = 0;   // retraits depuis le dernier recalcul complet
+    for (std::size_t t = 0; t < T; ++t) {
+        if (t >= W && ++slides >= options.refreshEvery) {
+            // ré-ancrage : fenêtre [t - W + 1, t] reconstruite de zéro, O(W n²)
+            cov.clear();
+            for (std::size_t r = t + 1 - W; r <= t; ++r) cov.add(aligned.row(r));
+            slides = 0;
+        } else {
+            cov.add(aligned.row(t));
+            if (t >= W) cov.remove(aligned.row(t - W));
+        }
+        if (t + 1 < W || (t + 1 - W) % options.step != 0) continue;
+
+        const std::size_t k = out.timestamps_.size();
+        out.timestamps_.push_back(aligned.timestamps()[t]);
+        const SymmetricMatrix& c = cov.comoments();
+        for (std::size_t i = 0; i < n; ++i) sd[i] = std::sqrt(std::max(0.0, c.row(i)[0]));
+        float* dst = out.values_.data() + k;
+        for (std::size_t i = 0; i < n; ++i) {
+            const double* src = c.row(i);
+            for (std::size_t j = i + 1; j < n; ++j, dst += steps) {
+                if (sd[i] <= 0.0 || sd[j] <= 0.0) continue;   // série constante sur la fenêtre
+                *dst = static_cast<float>(std::clamp(src[j - i] / (sd[i] * sd[j]), -1.0, 1.0));
+            }
+        }
+    }
+    return out;
+}
+
+std::size_t RollingCorrelationSeries::indexOf(const std::string& label) const {
+    return static_cast<std::size_t>(std::find(labels_.begin(), labels_.end(), label) - labels_.begin());
+}
+
+std::size_t RollingCorrelationSeries::pairIndex(std::size_t i, std::size_t j) const {
+    const std::size_t n = series();
+    if (i >= n || j >= n) throw std::out_of_range("RollingCorrelationSeries::pair: index out of range.");
+    if (i == j) throw std::invalid_argument("RollingCorrelationSeries::pair: i and j must differ.");
+    if (i > j) std::swap(i, j);
+    return i * (2 * n - i - 1) / 2 + (j - i - 1);
+}
+
+const float* RollingCorrelationSeries::pair(std::size_t i, std::size_t j) const {
+    return values_.data() + pairIndex(i, j) * steps();
+}
+
+std::vector<double> RollingCorrelationSeries::pairSeries(std::size_t i, std::size_t j) const {
+    const float* p = pair(i, j);
+    return std::vector<double>(p, p + steps());
+}
+
+CorrelationMatrix RollingCorrelationSeries::matrix(std::size_t step) const {
+    if (step >= steps()) throw std::out_of_range("RollingCorrelationSeries::matrix: step out of range.");
+    const std::size_t n = series();
+    CorrelationMatrix corr(labels_);
+    const float* src = values_.data() + step;
+    for (std::size_t i = 0; i < n; ++i) {
+        double* dst = corr.row(i);
+        for (std::size_t j = i + 1; j < n; ++j, src += steps()) dst[j - i] = *src;
+    }
+    return corr;
+}
@@ -0,0 +1,56 @@
+#ifndef ROLLING_CORRELATION_HPP
+#define ROLLING_CORRELATION_HPP
+
+#include "AlignedReturns.hpp"
+#include "CorrelationMatrix.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct RollingCorrelationOptions {
+    std::size_t window = 60;   // rendements par fenêtre
+    std::size_t step = 1;      // lignes entre deux fenêtres enregistrées
+    std::size_t refreshEvery = 1024;   // glissements entre deux recalculs complets de la fenêtre
+};
+
+// Corrélations glissantes d'un univers, une matrice par fenêtre, indexées par la
+// date de fin de fenêtre. Stockage par paire (i < j) : l'historique d'une paire est
+// contigu, en float (précision largement suffisante pour un coefficient dans [-1, 1]).
+class RollingCorrelationSeries {
+public:
+    RollingCorrelationSeries() = default;
+
+    // Fenêtre glissée ligne à ligne sur des co-moments de Welford (RunningCovariance) :
+    // une ligne ajoutée et une retirée par pas, O(n²) par pas au lieu de O(W n²).
+    // Toutes les refreshEvery glissements, la fenêtre est recalculée de zéro pour
+    // borner la dérive numérique des retraits successifs.
+    // invalid_argument si aligned n'est pas en Intersection, window < 2, step == 0
+    // ou refreshEvery == 0 ; aucune fenêtre si aligned a moins de window lignes.
+    static RollingCorrelationSeries compute(const AlignedReturns& aligned, const RollingCorrelationOptions& options = {});
+
+    std::size_t series() const { return labels_.size(); }
+    std::size_t steps() const { return timestamps_.size(); }
+    std::size_t window() const { return window_; }
+    const std::vector<std::string>& labels() const { return labels_; }
+    const std::vector<std::int64_t>& timestamps() const { return timestamps_; }   // fin de chaque fenêtre
+
+    // indice du label, series() si absent
+    std::size_t indexOf(const std::string& label) const;
+
+    // steps() valeurs de corr(i, j) ; out_of_range si i ou j hors bornes, invalid_argument si i == j
+    const float* pair(std::size_t i, std::size_t j) const;
+    std::vector<double> pairSeries(std::size_t i, std::size_t j) const;
+
+    CorrelationMatrix matrix(std::size_t step) const;
+
+private:
+    std::vector<std::string> labels_;
+    std::vector<std::int64_t> timestamps_;
+    std::vector<float> values_;   // paire par paire, steps() valeurs chacune
+    std::size_t window_ = 0;
+
+    std::size_t pairIndex(std::size_t i, std::size_t j) const;
+};
+
+#endif
@@ -0,0 +1,27 @@
+#include "RollingCrossSums.hpp"
+#include <stdexcept>
+
+RollingCrossSums::RollingCrossSums(std::size_t series) : stats_(series) {}
+
+void RollingCrossSums::pushBack(const double* row) {
+    if (!row && series() > 0) throw std::invalid_argument("RollingCrossSums::pushBack: row must be non-null.");
+    window_.emplace_back(row, row + series());
+    stats_.add(row);
+}
+
+void RollingCrossSums::popFront() {
+    if (window_.empty()) throw std::out_of_range("RollingCrossSums::popFront: window is empty.");
+    stats_.remove(window_.front().data());
+    window_.pop_front();
+}
+
+void RollingCrossSums::popBack() {
+    if (window_.empty()) throw std::out_of_range("RollingCrossSums::popBack: window is empty.");
+    stats_.remove(window_.back().data());
+    window_.pop_back();
+}
+
+void RollingCrossSums::clear() {
+    window_.clear();
+    stats_.clear();
+}
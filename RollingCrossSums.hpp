@@ -0,0 +1,39 @@
+#ifndef ROLLING_CROSS_SUMS_HPP
+#define ROLLING_CROSS_SUMS_HPP
+
+#include "CorrelationMatrix.hpp"
+#include "OnlineStats.hpp"
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Fenêtre glissante de lignes de rendements (une valeur par série) avec leurs
+// co-moments de Welford (RunningCovariance) : ajouter ou retirer une ligne coûte O(n²),
+// la corrélation se lit sans repasser sur la fenêtre.
+class RollingCrossSums {
+public:
+    explicit RollingCrossSums(std::size_t series = 0);
+
+    std::size_t series() const { return stats_.series(); }
+    std::size_t rows() const { return window_.size(); }
+    const std::vector<double>& row(std::size_t k) const { return window_[k]; }   // 0 = plus ancienne
+
+    // row : series() valeurs
+    void pushBack(const double* row);
+    void popFront();
+    void popBack();
+    void clear();
+
+    const RunningCovariance& stats() const { return stats_; }
+
+    // corr(i,j) = cov(i,j) / (sd_i sd_j), 0 pour une série constante ; labels optionnels
+    CorrelationMatrix correlation(std::vector<std::string> labels = {}) const { return stats_.correlation(std::move(labels)); }
+
+private:
+    std::deque<std::vector<double>> window_;
+    RunningCovariance stats_;
+};
+
+#endif
@@ -0,0 +1,43 @@
+#include "SymbolTable.hpp"
+#include <mutex>
+#include <stdexcept>
+
+SymbolTable& SymbolTable::global() {
+    static SymbolTable table;
+    return table;
+}
+
+AssetId SymbolTable::intern(const std::string& name) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = ids_.find(name);
+        if (it != ids_.end()) return it->second;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = ids_.find(name);
+    if (it != ids_.end()) return it->second;
+
+    const AssetId id = static_cast<AssetId>(names_.size());
+    if (id == kInvalidAssetId) throw std::length_error("SymbolTable::intern: too many symbols.");
+    names_.push_back(name);
+    ids_.emplace(name, id);
+    return id;
+}
+
+AssetId SymbolTable::find(const std::string& name) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = ids_.find(name);
+    return it == ids_.end() ? kInvalidAssetId : it->second;
+}
+
+const std::string& SymbolTable::name(AssetId id) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (id >= names_.size()) throw std::out_of_range("SymbolTable::name: unknown asset id.");
+    return names_[id];
+}
+
+std::size_t SymbolTable::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return names_.size();
+}
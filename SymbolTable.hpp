@@ -0,0 +1,32 @@
+#ifndef SYMBOL_TABLE_HPP
+#define SYMBOL_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+// Identifiant dense d'un ticker interné (0, 1, 2, ... dans l'ordre d'apparition)
+using AssetId = std::uint32_t;
+constexpr AssetId kInvalidAssetId = ~AssetId(0);
+
+// Table de symboles du processus : nom -> AssetId en O(1) (hash), AssetId -> nom.
+// Les noms sont stockés une seule fois ; les références renvoyées restent valides.
+class SymbolTable {
+private:
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<std::string, AssetId> ids_;
+    std::deque<std::string> names_;
+
+public:
+    static SymbolTable& global();
+
+    AssetId intern(const std::string& name);
+    AssetId find(const std::string& name) const;   // kInvalidAssetId si inconnu
+    const std::string& name(AssetId id) const;
+    std::size_t size() const;
+};
+
+#endif
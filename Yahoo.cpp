@@ -1,242 +1,424 @@
 #include "Yahoo.hpp"
-#ifdef _WIN32
-#include <windows.h>
-#include <winhttp.h>
+#include "ChartJson.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
-#include <sstream>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+#include <optional>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
-// #pragma comment(lib, "winhttp.lib") 
-
-static std::wstring toWide(const std::string& s) {
-    if (s.empty()) return L"";
-    int size_needed = MultiByteToWideChar(CP_UTF8, 0, s.c_str(), (int)s.size(), nullptr, 0);
-    std::wstring w(size_needed, 0);
-    MultiByteToWideChar(CP_UTF8, 0, s.c_str(), (int)s.size(), &w[0], size_needed);
-    return w;
+namespace {
+std::mutex g_transportMutex;
+std::shared_ptr<HttpTransport> g_transport;
+std::mutex g_storeMutex;
+std::shared_ptr<HistoryStore> g_store;
+bool g_storeInitialized = false;
+
+// plafond de requêtes chart simultanées pour tout le processus (jobs UI, tracker, lots)
+std::mutex g_slotMutex;
+std::condition_variable g_slotFreed;
+std::size_t g_maxInFlight = 8;
+std::size_t g_inFlight = 0;
+
+struct RequestSlot {
+    explicit RequestSlot(int timeoutMs) {
+        std::unique_lock<std::mutex> lock(g_slotMutex);
+        auto free = [] { return g_inFlight < g_maxInFlight; };
+        if (timeoutMs <= 0) g_slotFreed.wait(lock, free);
+        else if (!g_slotFreed.wait_for(lock, std::chrono::milliseconds(timeoutMs), free))
+            throw std::runtime_error("Yahoo: no request slot within timeout.");
+        ++g_inFlight;
+    }
+    ~RequestSlot() {
+        {
+            std::lock_guard<std::mutex> lock(g_slotMutex);
+            --g_inFlight;
+        }
+        g_slotFreed.notify_one();
+    }
+    RequestSlot(const RequestSlot&) = delete;
+    RequestSlot& operator=(const RequestSlot&) = delete;
+};
 }
 
-static std::string httpGetWinHTTP(const std::wstring& host, const std::wstring& path) {
-    HINTERNET hSession = WinHttpOpen(L"PortfolioProject/1.0",
-                                    WINHTTP_ACCESS_TYPE_DEFAULT_PROXY,
-                                    WINHTTP_NO_PROXY_NAME,
-                                    WINHTTP_NO_PROXY_BYPASS, 0);
-    if (!hSession) throw std::runtime_error("WinHttpOpen failed");
-
-    HINTERNET hConnect = WinHttpConnect(hSession, host.c_str(), INTERNET_DEFAULT_HTTPS_PORT, 0);
-    if (!hConnect) {
-        WinHttpCloseHandle(hSession);
-        throw std::runtime_error("WinHttpConnect failed");
+void setYahooMaxInFlight(std::size_t maxInFlight) {
+    if (maxInFlight == 0) throw std::invalid_argument("setYahooMaxInFlight: limit must be positive.");
+    {
+        std::lock_guard<std::mutex> lock(g_slotMutex);
+        g_maxInFlight = maxInFlight;
     }
+    g_slotFreed.notify_all();
+}
 
-    HINTERNET hRequest = WinHttpOpenRequest(hConnect, L"GET", path.c_str(),
-                                            nullptr, WINHTTP_NO_REFERER,
-                                            WINHTTP_DEFAULT_ACCEPT_TYPES,
-                                            WINHTTP_FLAG_SECURE);
-    if (!hRequest) {
-        WinHttpCloseHandle(hConnect);
-        WinHttpCloseHandle(hSession);
-        throw std::runtime_error("WinHttpOpenRequest failed");
-    }
+std::size_t yahooMaxInFlight() {
+    std::lock_guard<std::mutex> lock(g_slotMutex);
+    return g_maxInFlight;
+}
 
-    BOOL ok = WinHttpSendRequest(hRequest,
-                                 WINHTTP_NO_ADDITIONAL_HEADERS, 0,
-                                 WINHTTP_NO_REQUEST_DATA, 0,
-                                 0, 0);
-    if (!ok) {
-        WinHttpCloseHandle(hRequest);
-        WinHttpCloseHandle(hConnect);
-        WinHttpCloseHandle(hSession);
-        throw std::runtime_error("WinHttpSendRequest failed");
+void setYahooEndpoint(const HttpEndpoint& endpoint) {
+    setYahooTransport(makeHttpTransport(endpoint));
+}
+
+void setYahooTransport(std::shared_ptr<HttpTransport> transport) {
+    {
+        std::lock_guard<std::mutex> lock(g_transportMutex);
+        g_transport = std::move(transport);
     }
+    yahooHistoryCache().clear();   // nouvelle source : les historiques en cache ne valent plus
+}
 
-    ok = WinHttpReceiveResponse(hRequest, nullptr);
-    if (!ok) {
-        WinHttpCloseHandle(hRequest);
-        WinHttpCloseHandle(hConnect);
-        WinHttpCloseHandle(hSession);
-        throw std::runtime_error("WinHttpReceiveResponse failed");
+std::shared_ptr<HttpTransport> yahooTransport() {
+    std::lock_guard<std::mutex> lock(g_transportMutex);
+    if (!g_transport) {
+        const char* url = std::getenv("YAHOO_CHART_URL");
+        g_transport = makeHttpTransport(url && *url ? HttpEndpoint::parse(url) : HttpEndpoint());
     }
+    return g_transport;
+}
 
-    std::string response;
-    DWORD dwSize = 0;
-    do {
-        DWORD dwDownloaded = 0;
-        if (!WinHttpQueryDataAvailable(hRequest, &dwSize)) break;
-        if (dwSize == 0) break;
+void setYahooHistoryStore(std::shared_ptr<HistoryStore> store) {
+    std::lock_guard<std::mutex> lock(g_storeMutex);
+    g_store = std::move(store);
+    g_storeInitialized = true;
+}
 
-        std::vector<char> buffer(dwSize);
-        if (!WinHttpReadData(hRequest, buffer.data(), dwSize, &dwDownloaded)) break;
+std::shared_ptr<HistoryStore> yahooHistoryStore() {
+    std::lock_guard<std::mutex> lock(g_storeMutex);
+    if (!g_storeInitialized) {
+        const char* dir = std::getenv("YAHOO_HISTORY_DIR");
+        if (dir && *dir) g_store = std::make_shared<HistoryStore>(dir);
+        g_storeInitialized = true;
+    }
+    return g_store;
+}
 
-        response.append(buffer.data(), buffer.data() + dwDownloaded);
-    } while (dwSize > 0);
+HistoryCache& yahooHistoryCache() {
+    static HistoryCache cache;
+    return cache;
+}
 
-    WinHttpCloseHandle(hRequest);
-    WinHttpCloseHandle(hConnect);
-    WinHttpCloseHandle(hSession);
+static std::string chartPath(const std::string& ticker, const std::string& range, const std::string& interval) {
+    return "/v8/finance/chart/" + ticker + "?range=" + range + "&interval=" + interval;
+}
 
-    if (response.empty()) throw std::runtime_error("Empty HTTP response");
-    return response;
+// requête depuis period1 (inclus) jusqu'à maintenant : seule la queue manquante transite
+static std::string chartTailPath(const std::string& ticker, const std::string& interval, std::int64_t period1) {
+    const std::int64_t now = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    return "/v8/finance/chart/" + ticker + "?period1=" + std::to_string(period1) +
+           "&period2=" + std::to_string(std::max(now, period1) + 86400) + "&interval=" + interval;
 }
 
-// parsing ciblé : extrait "close":[ ... ]
-static std::vector<double> extractCloseArray(const std::string& json) {
-    const std::string key = "\"close\":[";
-    std::size_t pos = json.find(key);
-    if (pos == std::string::npos) throw std::runtime_error("Yahoo JSON: could not find close array.");
-    pos += key.size();
+// une requête chart sous le plafond global ; l'attente d'un créneau est bornée par timeoutMs
+static std::string chartGet(const std::string& path, int timeoutMs) {
+    const RequestSlot slot(timeoutMs);
+    return yahooTransport()->get(path, timeoutMs);
+}
 
-    std::size_t end = json.find(']', pos);
-    if (end == std::string::npos) throw std::runtime_error("Yahoo JSON: malformed close array.");
+// timestamps et closes alignés ; les jours à close null sont retirés des deux séries
+// allowEmpty : réponse sans barre (pas de tableau timestamp) => séries vides
+static void parseChartSeries(const std::string& json, std::vector<std::int64_t>& timestamps,
+                             std::vector<double>& closes, bool allowEmpty = false) {
+    ChartSeries chart = parseChartJson(json);
+    timestamps.clear();
+    closes.clear();
+    if (!chart.hasTimestamps) {
+        if (allowEmpty) return;
+        throw std::runtime_error("Yahoo JSON: could not find timestamp array.");
+    }
+    if (!chart.hasCloses) throw std::runtime_error("Yahoo JSON: could not find close array.");
+    if (chart.timestamps.size() != chart.closes.size()) {
+        throw std::runtime_error("Yahoo JSON: timestamp/close arrays differ in length.");
+    }
 
-    std::string arr = json.substr(pos, end - pos);
+    timestamps.reserve(chart.timestamps.size());
+    closes.reserve(chart.closes.size());
+    for (std::size_t i = 0; i < chart.closes.size(); ++i) {
+        if (std::isnan(chart.closes[i])) continue;
+        timestamps.push_back(chart.timestamps[i]);
+        closes.push_back(chart.closes[i]);
+    }
+}
 
+static PriceHistory parseChartHistory(const std::string& ticker, const std::string& json) {
+    std::vector<std::int64_t> timestamps;
     std::vector<double> closes;
-    std::stringstream ss(arr);
-    std::string token;
+    parseChartSeries(json, timestamps, closes);
+    return PriceHistory::fromCloses(ticker, std::move(timestamps), std::move(closes));
+}
+
+PriceHistory fetchPriceHistory(const HistoryKey& key, int timeoutMs) {
+    return parseChartHistory(key.ticker, chartGet(chartPath(key.ticker, key.range, key.interval), timeoutMs));
+}
 
-    while (std::getline(ss, token, ',')) {
-        if (token.find("null") != std::string::npos) continue;
+PriceHistory appendPriceHistoryTail(const PriceHistory& base, const HistoryKey& key, int timeoutMs) {
+    if (base.timestamps.empty()) return fetchPriceHistory(key, timeoutMs);
+    std::vector<std::int64_t> timestamps;
+    std::vector<double> closes;
+    const std::string json = chartGet(chartTailPath(key.ticker, key.interval, base.timestamps.back()), timeoutMs);
+    parseChartSeries(json, timestamps, closes, true);
+    // Yahoo peut renvoyer des barres antérieures à period1 : seules celles à partir de la dernière comptent
+    const auto first = std::lower_bound(timestamps.begin(), timestamps.end(), base.timestamps.back());
+    const std::size_t skip = first - timestamps.begin();
+    timestamps.erase(timestamps.begin(), first);
+    closes.erase(closes.begin(), closes.begin() + (long long)skip);
+
+    PriceHistory h = base;
+    h.appendBars(timestamps, closes, historyRangeSeconds(key.range));
+    return h;
+}
 
-        while (!token.empty() && (token.front() == ' ' || token.front() == '\n' || token.front() == '\r')) token.erase(token.begin());
-        while (!token.empty() && (token.back() == ' ' || token.back() == '\n' || token.back() == '\r')) token.pop_back();
+PriceHistory fetchPriceHistory1y(const std::string& ticker, int timeoutMs) {
+    return fetchPriceHistory(HistoryKey{ticker, "1y", "1d"}, timeoutMs);
+}
 
-        if (token.empty()) continue;
-        closes.push_back(std::stod(token));
+PriceHistory loadOrFetchPriceHistory(const HistoryKey& key, int timeoutMs) {
+    const std::shared_ptr<HistoryStore> store = yahooHistoryStore();
+    std::optional<PriceHistory> stale;
+    if (store) {
+        try {
+            if (const auto view = store->open(key)) {
+                PriceHistory stored = view->toPriceHistory(key.ticker);
+                if (store->isFresh(*view)) return stored;
+                stale = std::move(stored);
+            }
+        } catch (const std::exception&) {
+            // fichier lisible mais historique inexploitable : on repasse par le réseau
+        }
     }
 
-    if (closes.size() < 30) {
-        throw std::runtime_error("Not enough close prices returned by Yahoo (need ~30+).");
+    // fichier périmé : seule la queue depuis sa dernière barre est demandée
+    std::optional<PriceHistory> fetched;
+    if (stale) {
+        try {
+            fetched = appendPriceHistoryTail(*stale, key, timeoutMs);
+        } catch (const std::exception&) {
+            // queue inexploitable (fenêtre trop courte, réponse partielle) : historique complet
+        }
+    }
+    PriceHistory h = fetched ? std::move(*fetched) : fetchPriceHistory(key, timeoutMs);
+    if (store) {
+        try {
+            store->save(key, h);
+        } catch (const std::exception&) {
+            // disque plein / en lecture seule : le fetch reste valable, seul le warm start est perdu
+        }
     }
-    return closes;
+    return h;
 }
 
-static std::vector<double> closesToDailyLogReturns(const std::vector<double>& closes) {
-    std::vector<double> r;
-    r.reserve(closes.size() - 1);
-    for (std::size_t i = 1; i < closes.size(); ++i) {
-        if (closes[i-1] <= 0.0 || closes[i] <= 0.0) continue;
-        r.push_back(std::log(closes[i] / closes[i-1]));
+std::shared_ptr<const PriceHistory> cachedPriceHistory(const HistoryKey& key, int timeoutMs) {
+    return yahooHistoryCache().get(key, [&] { return loadOrFetchPriceHistory(key, timeoutMs); },
+                                  std::chrono::milliseconds(std::max(timeoutMs, 0)));
+}
+
+std::shared_ptr<const PriceHistory> refreshPriceHistory(const HistoryKey& key, int timeoutMs) {
+    const std::shared_ptr<const PriceHistory> base = cachedPriceHistory(key, timeoutMs);
+    auto next = std::make_shared<const PriceHistory>(appendPriceHistoryTail(*base, key, timeoutMs));
+    if (next->timestamps == base->timestamps && next->closes == base->closes) return base;
+
+    yahooHistoryCache().put(key, next);
+    if (const auto store = yahooHistoryStore()) {
+        try {
+            store->save(key, *next);
+        } catch (const std::exception&) {
+            // voir loadOrFetchPriceHistory : le store n'est qu'un accélérateur
+        }
     }
-    if (r.size() < 20) throw std::runtime_error("Not enough valid returns to compute stats.");
-    return r;
+    return next;
 }
 
-static std::pair<double,double> annualMuSigmaFromDailyLogReturns(const std::vector<double>& r) {
-    double mean = 0.0;
-    for (double x : r) mean += x;
-    mean /= (double)r.size();
+Asset fetchAssetFromYahoo(const std::string& ticker) {
+    return cachedPriceHistory(HistoryKey{ticker, "1y", "1d"})->toAsset();
+}
 
-    double var = 0.0;
-    for (double x : r) var += (x - mean) * (x - mean);
-    var /= (double)(r.size() - 1);
-    double stdev = std::sqrt(std::max(0.0, var));
+std::vector<double> fetchDailyLogReturns1y(const std::string& ticker) {
+    return cachedPriceHistory(HistoryKey{ticker, "1y", "1d"})->logReturns;
+}
 
-    // annualize (252 trading days)
-    return { mean * 252.0, stdev * std::sqrt(252.0) };
+// un historique selon options : queue, cache (+ store) ou réseau direct
+static std::shared_ptr<const PriceHistory> historyWithOptions(const HistoryKey& key, const YahooFetchOptions& options) {
+    if (options.refreshTail) return refreshPriceHistory(key, options.timeoutMs);
+    if (options.useCache) return cachedPriceHistory(key, options.timeoutMs);
+    return std::make_shared<const PriceHistory>(fetchPriceHistory(key, options.timeoutMs));
 }
 
-Asset fetchAssetFromYahoo(const std::string& ticker) {
-    const std::wstring host = L"query1.finance.yahoo.com";
-    std::wstring path = L"/v8/finance/chart/" + toWide(ticker) + L"?range=1y&interval=1d";
+std::vector<TickerHistory> fetchPriceHistories(const std::vector<std::string>& tickers, const std::string& range,
+                                               const std::string& interval, const YahooFetchOptions& options) {
+    const std::size_t n = tickers.size();
+    std::vector<TickerHistory> results(n);
+    if (n == 0) return results;
+
+    // chaque worker prend l'indice suivant et écrit à sa place : ordre d'entrée conservé
+    std::atomic<std::size_t> next{0};
+    auto worker = [&] {
+        for (std::size_t i = next.fetch_add(1); i < n; i = next.fetch_add(1)) {
+            TickerHistory& r = results[i];
+            r.ticker = tickers[i];
+            try {
+                r.history = historyWithOptions(HistoryKey{tickers[i], range, interval}, options);
+            } catch (const std::exception& e) {
+                r.history.reset();
+                r.error = e.what();
+                if (r.error.empty()) r.error = "unknown error";
+            }
+        }
+    };
+
+    // les requêtes passent de toute façon par le plafond global : inutile d'avoir plus de threads
+    const std::size_t workers = std::min({n, std::max<std::size_t>(1, options.maxInFlight), yahooMaxInFlight()});
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (std::size_t t = 1; t < workers; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& th : pool) th.join();
+    return results;
+}
 
-    std::string json = httpGetWinHTTP(host, path);
-    auto closes = extractCloseArray(json);
-    auto r = closesToDailyLogReturns(closes);
+std::vector<TickerHistory> fetchPriceHistories1y(const std::vector<std::string>& tickers,
+                                                 const YahooFetchOptions& options) {
+    return fetchPriceHistories(tickers, "1y", "1d", options);
+}
 
-    double lastPrice = closes.back();
-    auto [mu, sigma] = annualMuSigmaFromDailyLogReturns(r);
+YahooMarketData::YahooMarketData(YahooFetchOptions options) : options_(options) {}
 
-    return Asset(ticker, lastPrice, mu, sigma);
+std::shared_ptr<const PriceHistory> YahooMarketData::history(const HistoryKey& key) {
+    return historyWithOptions(key, options_);
 }
 
-std::vector<double> fetchDailyLogReturns1y(const std::string& ticker) {
-    const std::wstring host = L"query1.finance.yahoo.com";
-    std::wstring path = L"/v8/finance/chart/" + toWide(ticker) + L"?range=1y&interval=1d";
-
-    std::string json = httpGetWinHTTP(host, path);
-    auto closes = extractCloseArray(json);
-    return closesToDailyLogReturns(closes);
+std::vector<TickerHistory> YahooMarketData::histories(const std::vector<std::string>& tickers,
+                                                      const std::string& range, const std::string& interval) {
+    return fetchPriceHistories(tickers, range, interval, options_);
 }
 
-// corr(i,j) = cov(r_i, r_j) / (sd_i sd_j)
-static double correlation(const std::vector<double>& a, const std::vector<double>& b) {
-    if (a.size() != b.size() || a.size() < 2) {
-        throw std::invalid_argument("correlation: series size mismatch or too small.");
-    }
+CorrelationMatrix correlationMatrixFromHistories(const std::vector<PriceHistory>& histories, const AlignOptions& align) {
+    std::vector<const PriceHistory*> ptrs;
+    ptrs.reserve(histories.size());
+    for (const auto& h : histories) ptrs.push_back(&h);
+    return AlignedReturns::join(ptrs, align).correlation();
+}
 
-    const std::size_t n = a.size();
-    double meanA = 0.0, meanB = 0.0;
-    for (std::size_t i = 0; i < n; ++i) { meanA += a[i]; meanB += b[i]; }
-    meanA /= (double)n; meanB /= (double)n;
+CorrelationMatrix correlationMatrixFromHistories(const std::vector<std::shared_ptr<const PriceHistory>>& histories,
+                                                 const AlignOptions& align) {
+    std::vector<const PriceHistory*> ptrs;
+    ptrs.reserve(histories.size());
+    for (const auto& h : histories) ptrs.push_back(h.get());
+    return AlignedReturns::join(ptrs, align).correlation();
+}
 
-    double sxx = 0.0, syy = 0.0, sxy = 0.0;
-    for (std::size_t i = 0; i < n; ++i) {
-        const double da = a[i] - meanA;
-        const double db = b[i] - meanB;
-        sxx += da * da;
-        syy += db * db;
-        sxy += da * db;
+YahooCorrelationResult correlationMatrixFromYahooPartial(const std::vector<std::string>& tickers,
+                                                         const YahooFetchOptions& options, const AlignOptions& align) {
+    YahooCorrelationResult out;
+    std::vector<std::shared_ptr<const PriceHistory>> histories;
+    for (TickerHistory& r : fetchPriceHistories1y(tickers, options)) {
+        if (r.ok()) histories.push_back(std::move(r.history));
+        else out.failures.push_back(std::move(r));
     }
-
-    if (sxx <= 0.0 || syy <= 0.0) return 0.0; // série quasi constante
-    return sxy / std::sqrt(sxx * syy);
+    out.matrix = correlationMatrixFromHistories(histories, align);
+    return out;
 }
 
-std::vector<std::vector<double>> correlationMatrixFromYahoo(const std::vector<std::string>& tickers) {
-    const std::size_t n = tickers.size();
-    if (n == 0) return {};
-
-    // Fetch returns for each ticker
-    std::vector<std::vector<double>> returns(n);
-    for (std::size_t i = 0; i < n; ++i) {
-        returns[i] = fetchDailyLogReturns1y(tickers[i]);
+CorrelationMatrix correlationMatrixFromYahoo(const std::vector<std::string>& tickers,
+                                             const YahooFetchOptions& options, const AlignOptions& align) {
+    YahooCorrelationResult result = correlationMatrixFromYahooPartial(tickers, options, align);
+    if (!result.failures.empty()) {
+        std::string msg = "Yahoo fetch failed for " + std::to_string(result.failures.size()) + " ticker(s):";
+        for (const auto& f : result.failures) msg += " " + f.ticker + " (" + f.error + ");";
+        throw std::runtime_error(msg);
     }
+    return std::move(result.matrix);
+}
 
-    // Align lengths (simple approach): keep last minLen values
-    std::size_t minLen = returns[0].size();
-    for (std::size_t i = 1; i < n; ++i) minLen = std::min(minLen, returns[i].size());
-    if (minLen < 20) throw std::runtime_error("Not enough aligned returns to compute correlation matrix.");
+YahooCorrelationTracker::YahooCorrelationTracker(std::vector<std::string> tickers, YahooFetchOptions options,
+                                                 std::size_t rebuildEvery)
+    : tickers_(std::move(tickers)), options_(options), sums_(tickers_.size()),
+      rebuildEvery_(std::max<std::size_t>(1, rebuildEvery)) {}
+
+void YahooCorrelationTracker::rebuild(const AlignedReturns& aligned) {
+    sums_.clear();
+    rowTimestamps_.clear();
+    removals_ = 0;
+    if (aligned.series() == 0) return;
+    if (aligned.rows() < 20) throw std::runtime_error("Not enough aligned returns to compute correlation matrix.");
+    for (std::size_t t = 0; t < aligned.rows(); ++t) {
+        sums_.pushBack(aligned.row(t));
+        rowTimestamps_.push_back(aligned.timestamps()[t]);
+    }
+}
 
-    for (std::size_t i = 0; i < n; ++i) {
-        if (returns[i].size() > minLen) {
-            returns[i].erase(returns[i].begin(), returns[i].end() - (long long)minLen);
-        }
+// Les lignes sont identifiées par leur date : celles sorties de la fenêtre partent par
+// le début, la fin est réécrite à partir de la première ligne qui diffère (close révisé,
+// nouvelles séances). Une fenêtre qui s'étend vers le passé impose une reconstruction.
+bool YahooCorrelationTracker::advance(const AlignedReturns& aligned) {
+    const std::size_t n = aligned.series();
+    const std::size_t T = aligned.rows();
+    if (n != sums_.series() || T < 20) return false;
+    if (!rowTimestamps_.empty() && aligned.timestamps()[0] < rowTimestamps_.front()) return false;
+
+    while (!rowTimestamps_.empty() && rowTimestamps_.front() < aligned.timestamps()[0]) {
+        sums_.popFront();
+        rowTimestamps_.pop_front();
+        ++removals_;
     }
 
-    std::vector<std::vector<double>> corr(n, std::vector<double>(n, 0.0));
-    for (std::size_t i = 0; i < n; ++i) {
-        corr[i][i] = 1.0;
-        for (std::size_t j = i + 1; j < n; ++j) {
-            double c = correlation(returns[i], returns[j]);
-            // clamp safety
-            if (c < -1.0) c = -1.0;
-            if (c > 1.0) c = 1.0;
-            corr[i][j] = c;
-            corr[j][i] = c;
-        }
+    std::size_t keep = 0;
+    while (keep < rowTimestamps_.size() && keep < T && rowTimestamps_[keep] == aligned.timestamps()[keep] &&
+           std::equal(sums_.row(keep).begin(), sums_.row(keep).end(), aligned.row(keep))) {
+        ++keep;
     }
-    return corr;
+    while (sums_.rows() > keep) {
+        sums_.popBack();
+        rowTimestamps_.pop_back();
+        ++removals_;
+    }
+    for (std::size_t t = keep; t < T; ++t) {
+        sums_.pushBack(aligned.row(t));
+        rowTimestamps_.push_back(aligned.timestamps()[t]);
+    }
+    return true;
 }
-#else
 
-#include <stdexcept>
+void YahooCorrelationTracker::refresh() {
+    const bool first = histories_.empty();
+    YahooFetchOptions options = options_;
+    options.refreshTail = !first;
+    std::vector<TickerHistory> results = fetchPriceHistories1y(tickers_, options);
+
+    failures_.clear();
+    std::vector<std::shared_ptr<const PriceHistory>> next(tickers_.size());
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        if (results[i].ok()) {
+            next[i] = std::move(results[i].history);
+        } else {
+            if (!first) next[i] = histories_[i];
+            failures_.push_back(std::move(results[i]));
+        }
+    }
+    if (first && !failures_.empty()) {
+        std::string msg = "Yahoo fetch failed for " + std::to_string(failures_.size()) + " ticker(s):";
+        for (const auto& f : failures_) msg += " " + f.ticker + " (" + f.error + ");";
+        throw std::runtime_error(msg);
+    }
 
-Asset fetchAssetFromYahoo(const std::string&) {
-    throw std::runtime_error("Yahoo integration is only available on Windows in this build.");
-}
+    std::vector<const PriceHistory*> ptrs;
+    ptrs.reserve(next.size());
+    for (const auto& h : next) ptrs.push_back(h.get());
+    const AlignedReturns aligned = AlignedReturns::join(ptrs);
 
-std::vector<double> fetchDailyLogReturns1y(const std::string&) {
-    throw std::runtime_error("Yahoo integration is only available on Windows in this build.");
+    // au-delà de rebuildEvery_ retraits de Welford, reconstruction complète pour borner la dérive
+    incremental_ = !first && advance(aligned) && removals_ < rebuildEvery_;
+    if (!incremental_) rebuild(aligned);
+    histories_ = std::move(next);
 }
 
-std::vector<std::vector<double>> correlationMatrixFromYahoo(const std::vector<std::string>&) {
-    throw std::runtime_error("Yahoo integration is only available on Windows in this build.");
+CorrelationMatrix YahooCorrelationTracker::matrix() const {
+    return sums_.correlation(tickers_);
 }
-
-#endif
\ No newline at end of file
@@ -1,18 +1,152 @@
 #ifndef YAHOO_HPP
 #define YAHOO_HPP
 
+#include "AlignedReturns.hpp"
 #include "Asset.hpp"
+#include "CorrelationMatrix.hpp"
+#include "HistoryCache.hpp"
+#include "HistoryStore.hpp"
+#include "HttpTransport.hpp"
+#include "MarketDataSource.hpp"
+#include "PriceHistory.hpp"
+#include "RollingCrossSums.hpp"
+#include <cstddef>
+#include <deque>
+#include <memory>
 #include <string>
 #include <vector>
 
+// Transport des requêtes chart, partagé par tous les fetchs (connexions réutilisées).
+// Par défaut : endpoint de la variable YAHOO_CHART_URL (ex. http://127.0.0.1:8081
+// pour un serveur local qui rejoue du JSON enregistré), sinon Yahoo en HTTPS.
+// Changer de transport vide le cache d'historiques.
+void setYahooEndpoint(const HttpEndpoint& endpoint);
+void setYahooTransport(std::shared_ptr<HttpTransport> transport);
+std::shared_ptr<HttpTransport> yahooTransport();
+
+// Plafond de requêtes chart simultanées pour tout le processus (8 par défaut), quels que
+// soient les appelants ; une requête attend un créneau au plus son timeoutMs.
+void setYahooMaxInFlight(std::size_t maxInFlight);
+std::size_t yahooMaxInFlight();
+
+// Chart (ticker, range, interval), une requête réseau : closes, rendements, prix et mu/sigma
+PriceHistory fetchPriceHistory(const HistoryKey& key, int timeoutMs = 0);
+PriceHistory fetchPriceHistory1y(const std::string& ticker, int timeoutMs = 0);
+
+// Copie de base complétée par les barres depuis sa dernière (une requête period1) :
+// dernière barre révisée remplacée, fenêtre de key.range glissée vers l'avant
+PriceHistory appendPriceHistoryTail(const PriceHistory& base, const HistoryKey& key, int timeoutMs = 0);
+
+// Store disque consulté avant le réseau (nullptr = désactivé). Par défaut : répertoire
+// de la variable YAHOO_HISTORY_DIR si définie. Un fetch réseau réécrit le fichier.
+void setYahooHistoryStore(std::shared_ptr<HistoryStore> store);
+std::shared_ptr<HistoryStore> yahooHistoryStore();
+
+// Store frais ; store périmé => queue seulement ; sinon réseau (puis écriture dans le store)
+PriceHistory loadOrFetchPriceHistory(const HistoryKey& key, int timeoutMs = 0);
+
+// Cache d'historiques devant la couche Yahoo (TTL, plafond mémoire, singleflight),
+// rempli par loadOrFetchPriceHistory
+HistoryCache& yahooHistoryCache();
+std::shared_ptr<const PriceHistory> cachedPriceHistory(const HistoryKey& key, int timeoutMs = 0);
+
+// Rafraîchissement quotidien : historique en cache + queue depuis sa dernière barre,
+// réinséré dans le cache et le store. Renvoie l'historique en cache s'il n'a pas bougé.
+std::shared_ptr<const PriceHistory> refreshPriceHistory(const HistoryKey& key, int timeoutMs = 0);
+
+// Via le cache :
 // Asset depuis Yahoo : price = dernier close, mu/sigma annualisés depuis 1 an (log-returns)
 Asset fetchAssetFromYahoo(const std::string& ticker);
 
 // Renvoie les log-returns journaliers (1 an) pour un ticker
 std::vector<double> fetchDailyLogReturns1y(const std::string& ticker);
 
+// Étage de fetch concurrent : au plus maxInFlight requêtes simultanées pour cet appel
+// (yahooMaxInFlight() pour tout le processus), timeoutMs par requête HTTP d'un ticker
+// (0 = délai du transport ; sémantique totale ou par opération selon le transport, voir HttpTransport)
+struct YahooFetchOptions {
+    std::size_t maxInFlight = 8;
+    int timeoutMs = 10000;
+    bool useCache = true;   // false : réseau direct (ni cache mémoire ni store disque)
+    bool refreshTail = false;   // true : refreshPriceHistory (prioritaire sur useCache)
+};
+
+// Un résultat par ticker (TickerHistory), dans l'ordre d'entrée ; un échec n'interrompt pas les autres
+std::vector<TickerHistory> fetchPriceHistories(const std::vector<std::string>& tickers, const std::string& range,
+                                               const std::string& interval, const YahooFetchOptions& options = {});
+std::vector<TickerHistory> fetchPriceHistories1y(const std::vector<std::string>& tickers,
+                                                 const YahooFetchOptions& options = {});
+
+// MarketDataSource Yahoo : un historique suit options (cache/store, queue, réseau direct),
+// les lots passent par l'étage de fetch concurrent
+class YahooMarketData : public MarketDataSource {
+public:
+    explicit YahooMarketData(YahooFetchOptions options = {});
+
+    std::string name() const override { return "yahoo"; }
+    std::shared_ptr<const PriceHistory> history(const HistoryKey& key) override;
+    std::vector<TickerHistory> histories(const std::vector<std::string>& tickers, const std::string& range = "1y",
+                                         const std::string& interval = "1d") override;
+
+private:
+    YahooFetchOptions options_;
+};
+
+// Corrélation des log-returns alignés par date (AlignedReturns), labels = tickers des historiques
+CorrelationMatrix correlationMatrixFromHistories(const std::vector<PriceHistory>& histories,
+                                                 const AlignOptions& align = {});
+CorrelationMatrix correlationMatrixFromHistories(const std::vector<std::shared_ptr<const PriceHistory>>& histories,
+                                                 const AlignOptions& align = {});
+
+// Matrice sur les tickers récupérés (ordre d'entrée conservé) + échecs par ticker
+struct YahooCorrelationResult {
+    CorrelationMatrix matrix;
+    std::vector<TickerHistory> failures;   // history vide, error renseignée
+};
+YahooCorrelationResult correlationMatrixFromYahooPartial(const std::vector<std::string>& tickers,
+                                                         const YahooFetchOptions& options = {},
+                                                         const AlignOptions& align = {});
+
 // Calcule la matrice de corrélation à partir des log-returns Yahoo,
-// dans l'ordre exact des tickers fournis
-std::vector<std::vector<double>> correlationMatrixFromYahoo(const std::vector<std::string>& tickers);
+// dans l'ordre exact des tickers fournis (labels = tickers).
+// Lève runtime_error listant chaque ticker en échec.
+CorrelationMatrix correlationMatrixFromYahoo(const std::vector<std::string>& tickers,
+                                             const YahooFetchOptions& options = {},
+                                             const AlignOptions& align = {});
+
+// Corrélation d'un univers tenue à jour par sommes croisées glissantes : après la
+// construction, refresh() ne demande que la queue de chaque série et ne met à jour
+// les sommes que pour les lignes ajoutées, révisées ou sorties de la fenêtre.
+// Fenêtre = dates communes à toutes les séries (MissingReturns::Intersection).
+class YahooCorrelationTracker {
+public:
+    // rebuildEvery : lignes retirées des sommes glissantes entre deux reconstructions complètes
+    explicit YahooCorrelationTracker(std::vector<std::string> tickers, YahooFetchOptions options = {},
+                                     std::size_t rebuildEvery = 1024);
+
+    // Premier appel : runtime_error si un ticker échoue. Ensuite un ticker en échec
+    // garde son historique précédent et figure dans failures().
+    void refresh();
+
+    CorrelationMatrix matrix() const;
+    std::size_t windowLength() const { return sums_.rows(); }
+    bool lastRefreshIncremental() const { return incremental_; }
+    const std::vector<TickerHistory>& failures() const { return failures_; }
+    const std::vector<std::shared_ptr<const PriceHistory>>& histories() const { return histories_; }
+
+private:
+    std::vector<std::string> tickers_;
+    YahooFetchOptions options_;
+    std::vector<std::shared_ptr<const PriceHistory>> histories_;
+    RollingCrossSums sums_;
+    std::deque<std::int64_t> rowTimestamps_;   // date de chaque ligne de sums_
+    std::vector<TickerHistory> failures_;
+    bool incremental_ = false;
+    std::size_t rebuildEvery_;
+    std::size_t removals_ = 0;   // popFront/popBack depuis la dernière reconstruction
+
+    void rebuild(const AlignedReturns& aligned);
+    bool advance(const AlignedReturns& aligned);
+};
 
 #endif
@@ -1,11 +1,14 @@
 #include "Asset.hpp"
+#include "AssetRegistry.hpp"
+#include "MarketDataSource.hpp"
 #include "Portfolio.hpp"
-#include "Yahoo.hpp"
 
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <vector>
 #include <iomanip>
+#include <utility>
 
 static void clearCin() {
     std::cin.clear();
@@ -15,12 +18,12 @@ static void clearCin() {
 static void printMenu() {
     std::cout << "\n========== PORTFOLIO MANAGER ==========\n"
               << "1) Add position (manual)\n"
-              << "2) Add position (Yahoo Finance fetch)\n"
+              << "2) Add position (market data fetch)\n"
               << "3) Remove position\n"
               << "4) Show portfolio + order for corr matrix\n"
               << "5) Compute expected return + volatility (enter corr matrix)\n"
               << "6) Merge with demo portfolio (operator+)\n"
-              << "7) Compute volatility with AUTO correlation from Yahoo\n"
+              << "7) Compute volatility with AUTO correlation from market data\n"
               << "0) Quit\n";
 }
 
@@ -54,8 +57,11 @@ static std::vector<std::vector<double>> readCorrMatrix(std::size_t n) {
     return corr;
 }
 
-int main() {
+int main(int argc, char** argv) {
     try {
+        // --data=yahoo|file:<dir>|memory, sinon MARKET_DATA, sinon Yahoo
+        const std::shared_ptr<MarketDataSource> source = configureMarketDataSource(argc, argv);
+        std::cout << "Market data: " << source->name() << "\n";
         Portfolio p;
 
         while (true) {
@@ -89,8 +95,9 @@ int main() {
                 std::cout << "Quantity: ";
                 std::cin >> qty;
 
-                std::cout << "Fetching " << ticker << " from Yahoo...\n";
-                Asset a = fetchAssetFromYahoo(ticker);
+                std::cout << "Fetching " << ticker << " from " << source->name() << "...\n";
+                // ticker déjà connu : on pousse le nouveau prix à tous les détenteurs
+                Asset a = AssetRegistry::global().upsert(source->history(HistoryKey{ticker})->toAsset());
 
                 std::cout << "Fetched: price=" << a.price()
                           << " mu=" << a.expectedReturn()
@@ -138,7 +145,7 @@ int main() {
                 p2.addPosition(Asset("DEMO_A", 100.0, 0.05, 0.10), 1);
                 p2.addPosition(Asset("DEMO_B", 200.0, 0.07, 0.15), 2);
 
-                Portfolio merged = p + p2; // operator+ 
+                Portfolio merged = p + std::move(p2); // operator+ (rvalue : positions de p2 déplacées)
                 std::cout << "Merged portfolio:\n";
                 showPortfolio(merged);
             }
@@ -152,15 +159,15 @@ int main() {
                 // Ordre stable du portfolio (tri lexical via map)
                 auto tickers = p.assetOrder();
 
-                std::cout << "Fetching returns and building correlation matrix from Yahoo...\n";
+                std::cout << "Fetching returns and building correlation matrix from " << source->name() << "...\n";
                 for (const auto& t : tickers) std::cout << "  - " << t << "\n";
 
-                auto corr = correlationMatrixFromYahoo(tickers);
+                auto corr = correlationMatrixFromSource(*source, tickers);
 
                 std::cout << "\nAuto correlation matrix (order = assetOrder):\n";
                 for (std::size_t i = 0; i < corr.size(); ++i) {
                     for (std::size_t j = 0; j < corr.size(); ++j) {
-                        std::cout << std::fixed << std::setprecision(3) << corr[i][j] << " ";
+                        std::cout << std::fixed << std::setprecision(3) << corr(i, j) << " ";
                     }
                     std::cout << "\n";
                 }
@@ -1,30 +1,81 @@
 #include "Asset.hpp"
+#include "CorrelationMatrix.hpp"
+#include "JobQueue.hpp"
+#include "JsonWriter.hpp"
 #include "Portfolio.hpp"
+#include "RiskKernels.hpp"
+#include "MarketDataSource.hpp"
+#include "RollingCorrelation.hpp"
 #include "Yahoo.hpp"
 #include "httplib.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <charconv>
 #include <cmath>
 #include <iomanip>
-#include <mutex>
+#include <optional>
 #include <stdexcept>
 #include <sstream>
 #include <limits>
+#include <memory>
 #include <cstdint>
 #include <string>
+#include <system_error>
+#include <utility>
 #include <vector>
 
-static Portfolio g_portfolio;
-static std::mutex g_mutex;
-static std::vector<std::vector<double>> g_last_corr;
-static std::vector<std::string> g_last_corr_labels;
-static std::string g_last_corr_source;
-static bool g_has_last_corr = false;
-static bool g_has_last_what_if = false;
-static std::string g_last_what_if_html;
-static bool g_has_last_optimization = false;
-static std::string g_last_optimization_html;
+struct OptimizationResult;
+
+// État de l'UI : instantané immuable publié par shared_ptr atomique. Un lecteur prend
+// l'instantané courant sans attendre les écrivains ; un écrivain copie l'état, le
+// modifie, recalcule la vue puis publie par compare-and-swap (et recommence si un
+// autre écrivain a publié entre-temps). Les calculs lourds tournent sur une copie.
+// Portefeuille d'un état. Les méthodes const de Portfolio remplissent des caches
+// internes (snapshot, ordre, tracker) et ne sont pas sûres en lecture concurrente :
+// un état publié (const) n'en donne qu'une copie privée, seul l'écrivain accède au
+// portefeuille de sa propre copie de l'état. refreshView remplit les caches avant
+// publication, les copies en héritent.
+class StatePortfolio {
+public:
+    Portfolio copy() const { return portfolio_; }
+    Portfolio& edit() { return portfolio_; }
+
+private:
+    Portfolio portfolio_;
+};
+
+struct UiState {
+    StatePortfolio portfolio;
+    std::uint64_t revision = 0;   // change à chaque modification du portefeuille ou de la corrélation
+    ValidatedCorrelation lastCorr;   // validée une fois, partagée par les rendus
+    std::string lastCorrSource;
+    bool hasLastCorr = false;
+    std::string whatIfHtml;         // vide : pas de résultat
+    std::string optimizationHtml;
+    std::shared_ptr<const OptimizationResult> optimization;   // même résultat, pour l'API
+    // corrélations glissantes (toutes les paires) ; le graphique montre la paire choisie
+    std::shared_ptr<const RollingCorrelationSeries> rolling;
+    std::string rollingRange;
+    std::size_t rollingA = 0;
+    std::size_t rollingB = 1;
+
+    // vue calculée avant publication (refreshView), lue par les pages et l'API
+    std::vector<std::string> order;
+    PortfolioSnapshot snapshot;        // ordre de order
+    double expectedReturn = 0.0;
+    std::optional<RiskReport> risk;    // si lastCorr est compatible avec order
+    std::string portfolioHtml;
+    std::string correlationHtml;
+};
+
+static std::shared_ptr<const UiState> g_state = std::make_shared<const UiState>();
+static std::atomic<std::uint64_t> g_revision{0};
+
+static std::shared_ptr<const UiState> loadState() {
+    return std::atomic_load(&g_state);
+}
 
 // helpers 
 static std::string htmlEscape(const std::string& s) {
@@ -51,6 +102,15 @@ static bool parseDouble(const std::string& s, double& out) {
     } catch (...) { return false; }
 }
 
+// entier décimal non signé sur toute la chaîne : ni signe, ni fraction, ni exposant ;
+// false au-delà de la plage de T
+template <typename T>
+static bool parseUnsigned(const std::string& s, T& out) {
+    const char* end = s.data() + s.size();
+    const auto r = std::from_chars(s.data(), end, out);
+    return !s.empty() && r.ec == std::errc() && r.ptr == end;
+}
+
 // Parse matrix from textarea:
 // rows separated by newline, values separated by spaces or commas.
 // Example (3x3):
@@ -115,13 +175,13 @@ static std::vector<std::string> splitCSVLine(const std::string& line, char delim
     return out;
 }
 
-static std::string exportPortfolioCSV(const Portfolio& p,
-                                      const std::vector<std::vector<double>>& corr,
-                                      bool corrAvailable) {
+// risk == nullptr : pas de matrice de corrélation compatible
+static std::string exportPortfolioCSV(const Portfolio& p, const RiskReport* risk) {
     std::ostringstream os;
     os << "name,qty,price,mu,sigma,value\n";
-    for (const auto& name : p.assetOrder()) {
-        const auto& pos = p[name];
+    for (std::size_t k = 0; k < p.size(); ++k) {
+        const auto& pos = p.positionAt(k);
+        const auto& name = pos.asset.name();
         os << name << ","
            << pos.quantity << ","
            << pos.asset.price() << ","
@@ -133,14 +193,12 @@ static std::string exportPortfolioCSV(const Portfolio& p,
     os << "\nmetric,value\n";
     os << "total_value," << p.totalValue() << "\n";
     os << "expected_return," << p.expectedReturn() << "\n";
-    if (corrAvailable) {
-        os << "volatility," << p.volatilityApprox(corr) << "\n";
+    if (risk) {
+        os << "volatility," << risk->volatility << "\n";
         const auto ord = p.assetOrder();
-        const auto contrib = p.varianceContributionsApprox(corr);
-        const double totalVar = p.varianceApprox(corr);
-        if (totalVar > 0.0 && contrib.size() == ord.size()) {
+        if (risk->variance > 0.0 && risk->riskShares.size() == ord.size()) {
             for (std::size_t i = 0; i < ord.size(); ++i) {
-                os << "risk_share_" << ord[i] << "," << (contrib[i] / totalVar) << "\n";
+                os << "risk_share_" << ord[i] << "," << risk->riskShares[i] << "\n";
             }
         }
     }
@@ -203,21 +261,24 @@ struct PortfolioPoint {
     double score = 0.0;
 };
 
-static double expectedReturnFromWeights(const std::vector<double>& w, const std::vector<double>& mu) {
+struct OptimizationResult {
+    std::string objective;
+    std::vector<std::string> names;
+    PortfolioPoint current;
+    PortfolioPoint best;
+    std::size_t candidates = 0;
+};
+
+static double expectedReturnFromWeights(const std::vector<double>& w, const double* mu) {
     double er = 0.0;
     for (std::size_t i = 0; i < w.size(); ++i) er += w[i] * mu[i];
     return er;
 }
 
 static double volatilityFromWeights(const std::vector<double>& w,
-                                    const std::vector<double>& sigma,
-                                    const std::vector<std::vector<double>>& corr) {
-    double var = 0.0;
-    for (std::size_t i = 0; i < w.size(); ++i) {
-        for (std::size_t j = 0; j < w.size(); ++j) {
-            var += w[i] * w[j] * sigma[i] * sigma[j] * corr[i][j];
-        }
-    }
+                                    const double* sigma,
+                                    const CorrelationMatrix& corr) {
+    const double var = sigmaScaledQuadForm(corr, w.data(), sigma);
     return std::sqrt(std::max(0.0, var));
 }
 
@@ -304,8 +365,9 @@ static std::string portfolioTableHTML(const Portfolio& p) {
     os << "<table border='1' cellpadding='6' cellspacing='0'>"
        << "<tr><th>Asset</th><th>Qty</th><th>Price</th><th>Mu (%)</th><th>Sigma (%)</th><th>Value</th></tr>";
 
-    for (const auto& name : p.assetOrder()) {
-        const auto& pos = p[name];
+    for (std::size_t k = 0; k < p.size(); ++k) {
+        const auto& pos = p.positionAt(k);
+        const auto& name = pos.asset.name();
         os << "<tr>"
            << "<td>" << htmlEscape(name) << "</td>"
            << "<td>" << pos.quantity << "</td>"
@@ -328,12 +390,67 @@ static std::string fmtPercent(double x, int precision = 2) {
     return fmt(x * 100.0, precision) + "%";
 }
 
-static bool hasCompatibleMatrixSize(const std::vector<std::vector<double>>& matrix, std::size_t n) {
-    if (matrix.size() != n) return false;
-    for (const auto& row : matrix) {
-        if (row.size() != n) return false;
+// AAAA-MM-JJ (UTC) d'un horodatage Unix
+static std::string fmtDate(std::int64_t ts) {
+    std::int64_t z = (ts >= 0 ? ts : ts - 86399) / 86400 + 719468;
+    const std::int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const std::int64_t doe = z - era * 146097;
+    const std::int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const std::int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const std::int64_t mp = (5 * doy + 2) / 153;
+    const std::int64_t d = doy - (153 * mp + 2) / 5 + 1;
+    const std::int64_t m = mp < 10 ? mp + 3 : mp - 9;
+    const std::int64_t y = yoe + era * 400 + (m <= 2);
+    std::ostringstream os;
+    os << y << '-' << std::setw(2) << std::setfill('0') << m << '-' << std::setw(2) << d;
+    return os.str();
+}
+
+static std::string rollingCorrelationSVG(const RollingCorrelationSeries& rolling, std::size_t a, std::size_t b) {
+    const std::size_t steps = rolling.steps();
+    if (steps == 0) return "<p class='muted'>History shorter than the window.</p>";
+    const float* corr = rolling.pair(a, b);
+
+    const double w = 760.0;
+    const double h = 260.0;
+    const double pad = 35.0;
+    auto px = [&](std::size_t k) { return pad + (steps > 1 ? (double)k / (double)(steps - 1) : 0.5) * (w - 2.0 * pad); };
+    auto py = [&](double c) { return h - pad - (c + 1.0) / 2.0 * (h - 2.0 * pad); };
+
+    std::ostringstream os;
+    os << "<div><b>" << htmlEscape(rolling.labels()[a]) << " / " << htmlEscape(rolling.labels()[b])
+       << " (" << rolling.window() << "-day window)</b><br/>";
+    os << "<svg width='" << w << "' height='" << h << "' viewBox='0 0 " << w << " " << h << "' "
+       << "style='border:1px solid #d1d5db;border-radius:10px;background:#fff'>";
+    for (double c : {-1.0, 0.0, 1.0}) {
+        os << "<line x1='" << pad << "' y1='" << py(c) << "' x2='" << (w-pad) << "' y2='" << py(c)
+           << "' stroke='" << (c == 0.0 ? "#9ca3af" : "#e5e7eb") << "'/>";
+        os << "<text x='4' y='" << (py(c)+4) << "' font-size='11' fill='#6b7280'>" << fmt(c, 1) << "</text>";
     }
-    return true;
+    os << "<polyline fill='none' stroke='#2563eb' stroke-width='1.5' points='";
+    for (std::size_t k = 0; k < steps; ++k) os << fmt(px(k), 1) << ',' << fmt(py(corr[k]), 1) << ' ';
+    os << "'/>";
+    os << "<text x='" << pad << "' y='" << (h-10) << "' font-size='11' fill='#6b7280'>"
+       << fmtDate(rolling.timestamps().front()) << "</text>";
+    os << "<text x='" << (w-pad) << "' y='" << (h-10) << "' font-size='11' fill='#6b7280' text-anchor='end'>"
+       << fmtDate(rolling.timestamps().back()) << "</text>";
+    os << "</svg></div>";
+    os << "<p class='muted'>Last: " << fmt(corr[steps - 1], 3) << " | " << steps << " windows</p>";
+    return os.str();
+}
+
+static std::string rollingCorrelationHTML(const UiState& state) {
+    if (!state.rolling) return "";
+    std::ostringstream os;
+    os << "<div class='card'><h3>Rolling correlation (" << htmlEscape(state.rollingRange) << ")</h3>"
+       << rollingCorrelationSVG(*state.rolling, state.rollingA, state.rollingB) << "</div>";
+    return os.str();
+}
+
+// taille + labels (si présents) alignés sur l'ordre du portefeuille
+static bool hasCompatibleMatrix(const ValidatedCorrelation& matrix, const std::vector<std::string>& order) {
+    if (matrix.size() != order.size()) return false;
+    return matrix.labels().empty() || matrix.labels() == order;
 }
 
 static std::string corrColor(double c) {
@@ -359,9 +476,10 @@ static std::string corrColor(double c) {
     return os.str();
 }
 
-static std::string correlationMatrixHTML(const std::vector<std::vector<double>>& corr,
-                                         const std::vector<std::string>& labels,
+static std::string correlationMatrixHTML(const ValidatedCorrelation& handle,
                                          const std::string& source) {
+    const CorrelationMatrix& corr = handle.matrix();
+    const auto& labels = corr.labels();
     if (corr.empty() || labels.empty()) return "";
 
     std::ostringstream os;
@@ -379,9 +497,9 @@ static std::string correlationMatrixHTML(const std::vector<std::vector<double>>&
 
     for (std::size_t i = 0; i < corr.size(); ++i) {
         os << "<tr><th>" << htmlEscape(labels[i]) << "</th>";
-        for (std::size_t j = 0; j < corr[i].size(); ++j) {
-            os << "<td style='background:" << corrColor(corr[i][j]) << "'>"
-               << fmt(corr[i][j], 3) << "</td>";
+        for (std::size_t j = 0; j < corr.size(); ++j) {
+            os << "<td style='background:" << corrColor(corr(i, j)) << "'>"
+               << fmt(corr(i, j), 3) << "</td>";
         }
         os << "</tr>";
     }
@@ -406,54 +524,39 @@ static std::string orderHTML(const Portfolio& p) {
 
 static std::string weightsHTML(const Portfolio& p) {
     std::ostringstream os;
-    const double total = p.totalValue();
+    const PortfolioSnapshot& s = p.snapshot();
     os << "<p><b>Weights:</b><br/>";
-    if (total <= 0.0) {
+    if (s.totalValue <= 0.0) {
         os << "Portfolio empty.</p>";
         return os.str();
     }
-    for (const auto& name : p.assetOrder()) {
-        const auto& pos = p[name];
-        const double w = pos.value() / total;
-        os << htmlEscape(name) << " : " << w << "<br/>";
+    const auto names = p.assetOrder();
+    for (std::size_t i = 0; i < s.n; ++i) {
+        os << htmlEscape(names[i]) << " : " << s.weight[i] << "<br/>";
     }
     os << "</p>";
     return os.str();
 }
 
-static std::string whatIfResultHTML() {
-    if (!g_has_last_what_if) return "";
+static std::string whatIfResultHTML(const UiState& state) {
+    if (state.whatIfHtml.empty()) return "";
     std::ostringstream os;
-    os << "<div class='card'><h3>What-if simulation result</h3>" << g_last_what_if_html << "</div>";
+    os << "<div class='card'><h3>What-if simulation result</h3>" << state.whatIfHtml << "</div>";
     return os.str();
 }
 
-static std::string optimizationResultHTML() {
-    if (!g_has_last_optimization) return "";
+static std::string optimizationResultHTML(const UiState& state) {
+    if (state.optimizationHtml.empty()) return "";
     std::ostringstream os;
-    os << "<div class='card'><h3>Optimization result</h3>" << g_last_optimization_html << "</div>";
+    os << "<div class='card'><h3>Optimization result</h3>" << state.optimizationHtml << "</div>";
     return os.str();
 }
 
-static std::string riskBreakdownHTML(const Portfolio& p,
-                                     const std::vector<std::vector<double>>& corr,
-                                     bool corrAvailable) {
+static std::string riskSharesHTML(const std::vector<std::string>& names,
+                                  const std::vector<double>& contrib,
+                                  double totalVariance) {
     std::ostringstream os;
     os << "<p><b>Risk contribution (variance decomposition):</b><br/>";
-
-    const auto names = p.assetOrder();
-    if (names.empty()) {
-        os << "Portfolio empty.</p>";
-        return os.str();
-    }
-
-    if (!corrAvailable) {
-        os << "N/A (compute metrics first).</p>";
-        return os.str();
-    }
-
-    const auto contrib = p.varianceContributionsApprox(corr);
-    const double totalVariance = p.varianceApprox(corr);
     if (totalVariance <= 0.0 || contrib.size() != names.size()) {
         os << "N/A (variance is zero).</p>";
         return os.str();
@@ -468,12 +571,161 @@ static std::string riskBreakdownHTML(const Portfolio& p,
     return os.str();
 }
 
+static std::string riskBreakdownHTML(const std::vector<std::string>& names, const RiskReport* risk) {
+    if (names.empty()) return "<p><b>Risk contribution (variance decomposition):</b><br/>Portfolio empty.</p>";
+    if (!risk) {
+        return "<p><b>Risk contribution (variance decomposition):</b><br/>N/A (compute metrics first).</p>";
+    }
+    return riskSharesHTML(names, risk->contributions, risk->variance);
+}
+
+struct WhatIfResult {
+    std::vector<std::string> names;   // ordre du portefeuille simulé
+    double totalValue = 0.0;
+    double expectedReturn = 0.0;
+    bool hasRisk = false;             // faux tant qu'aucune corrélation compatible
+    double variance = 0.0;
+    double volatility = 0.0;
+    std::vector<double> contributions;
+};
+
+// Simulation sur une copie du portefeuille de l'instantané, sans verrou.
+// out_of_range si name est inconnu pour un ajout, invalid_argument pour un retrait impossible.
+static WhatIfResult simulateWhatIf(const UiState& state, const std::string& name, double qtyDelta) {
+    Portfolio simulated = state.portfolio.copy();
+    if (qtyDelta > 0.0) {
+        // lecture const : operator[] non-const marquerait le tracker stale (recalcul O(n²))
+        const Position* pos = std::as_const(simulated).find(name);
+        if (!pos) throw std::out_of_range("what_if: asset not found: " + name);
+        simulated.addPosition(pos->asset, qtyDelta);
+    } else {
+        simulated.removePosition(name, std::fabs(qtyDelta));
+    }
+
+    WhatIfResult out;
+    out.names = simulated.assetOrder();
+    out.totalValue = simulated.totalValue();
+    out.expectedReturn = simulated.expectedReturn();
+    if (simulated.riskTracked()) {
+        // mise à jour O(n) depuis l'état suivi du portefeuille courant
+        out.hasRisk = true;
+        out.variance = simulated.trackedVariance();
+        out.volatility = simulated.trackedVolatility();
+        out.contributions = simulated.trackedContributions();
+    } else if (state.hasLastCorr && hasCompatibleMatrix(state.lastCorr, out.names)) {
+        RiskReport risk = simulated.riskReport(state.lastCorr);
+        out.hasRisk = true;
+        out.variance = risk.variance;
+        out.volatility = risk.volatility;
+        out.contributions = std::move(risk.contributions);
+    }
+    return out;
+}
+
+// Rendu de la partie portefeuille, fait une fois par publication sur l'état privé
+// de l'écrivain : pageHTML n'appelle ensuite aucune méthode de Portfolio.
+static void refreshView(UiState& state) {
+    const Portfolio& p = state.portfolio.edit();
+    state.order = p.assetOrder();
+    state.snapshot = p.snapshot();
+    state.expectedReturn = p.expectedReturn();
+    state.risk.reset();
+    if (state.hasLastCorr && hasCompatibleMatrix(state.lastCorr, state.order)) {
+        state.risk = p.riskReport(state.lastCorr);
+    }
+    const std::optional<RiskReport>& risk = state.risk;
+
+    std::ostringstream os;
+    os << portfolioTableHTML(p);
+    os << "<div class='metrics'>"
+       << "<div class='metric'><b>Total value</b><br/>" << fmt(p.totalValue(), 2) << "</div>"
+       << "<div class='metric'><b>Expected return</b><br/>" << fmtPercent(state.expectedReturn, 2) << "</div>"
+       << "<div class='metric'><b>Volatility</b><br/>"
+       << (risk ? fmtPercent(risk->volatility, 2) : std::string("N/A (compute metrics first)"))
+       << "</div>"
+       << "</div>";
+    os << orderHTML(p);
+    os << weightsHTML(p);
+    os << riskBreakdownHTML(state.order, risk ? &*risk : nullptr);
+    state.portfolioHtml = os.str();
+    state.correlationHtml = state.hasLastCorr ? correlationMatrixHTML(state.lastCorr, state.lastCorrSource) : "";
+}
+
+// Publie mutate(copie de l'état courant). mutate peut être rejoué si un autre
+// écrivain publie entre la copie et le CAS : il ne doit dépendre que de l'état reçu.
+// Une exception dans mutate ne publie rien.
+template <typename Mutate>
+static std::shared_ptr<const UiState> updateState(Mutate mutate) {
+    std::shared_ptr<const UiState> current = loadState();
+    for (;;) {
+        auto next = std::make_shared<UiState>(*current);
+        mutate(*next);
+        refreshView(*next);
+        std::shared_ptr<const UiState> published = std::move(next);
+        if (std::atomic_compare_exchange_strong(&g_state, &current, published)) return published;
+    }
+}
+
+// Modification du portefeuille : nouvelle révision, l'optimisation affichée ne vaut plus.
+static void portfolioChanged(UiState& state) {
+    state.revision = ++g_revision;
+    state.optimizationHtml.clear();
+    state.optimization.reset();
+}
+
+// fenêtre glissante maximale : ~10 ans de séances, la plus longue plage proposée
+static constexpr std::size_t kMaxRollingWindow = 2520;
+
+// Jobs longs (/optimize, /metrics_auto) : file bornée et 2 workers ; le thread
+// httplib ne fait que soumettre et rendre la page, qui suit l'avancement.
+static JobQueue& jobQueue() {
+    static JobQueue jobs([] {
+        JobQueue::Options options;
+        options.workers = 2;
+        options.capacity = 16;
+        return options;
+    }());
+    return jobs;
+}
+
+static std::string jobMessage(const std::string& what, const JobQueue::Submission& job) {
+    return what + (job.coalesced ? " already running as job #" : " queued as job #") + std::to_string(job.id) + ".";
+}
+
+static std::string jobKind(const JobInfo& job) {
+    return job.key.substr(0, job.key.find('|'));
+}
+
+static std::string jobsHTML(const std::vector<JobInfo>& jobs) {
+    if (jobs.empty()) return "";
+    std::ostringstream os;
+    os << "<div class='card'><h3>Jobs</h3><table><tr><th>#</th><th>Job</th><th>Status</th><th>Progress</th><th>Message</th><th></th></tr>";
+    for (const auto& job : jobs) {
+        os << "<tr><td>" << job.id << "</td><td>" << htmlEscape(jobKind(job)) << "</td><td>" << jobStatusName(job.status)
+           << "</td><td>" << fmtPercent(job.progress, 0) << "</td><td>"
+           << htmlEscape(job.status == JobStatus::Failed ? "Error: " + job.error : job.result) << "</td><td>";
+        if (!job.finished()) os << "<a href='/cancel_job?id=" << job.id << "'>Cancel</a>";
+        os << "</td></tr>";
+    }
+    os << "</table>";
+    const JobQueue::Stats stats = jobQueue().stats();
+    os << "<p class='muted'>" << stats.running << " running, " << stats.queued << " queued, "
+       << stats.coalesced << " duplicate submissions coalesced</p></div>";
+    return os.str();
+}
+
 static std::string pageHTML(const std::string& message = "") {
-    std::lock_guard<std::mutex> lock(g_mutex);
+    const std::shared_ptr<const UiState> state = loadState();
+    const std::vector<std::string>& order = state->order;
+    const std::vector<JobInfo> jobs = jobQueue().recent(8);
     std::ostringstream os;
 
-    os << "<!doctype html><html><head><meta charset='utf-8'/>"
-    << "<meta name='viewport' content='width=device-width, initial-scale=1'/>"
+    os << "<!doctype html><html><head><meta charset='utf-8'/>";
+    // job en file ou en cours : la page se recharge jusqu'à la fin (résultat publié dans l'état)
+    if (std::any_of(jobs.begin(), jobs.end(), [](const JobInfo& j) { return !j.finished(); })) {
+        os << "<meta http-equiv='refresh' content='2;url=/'/>";
+    }
+    os << "<meta name='viewport' content='width=device-width, initial-scale=1'/>"
        << "<title>Portfolio Manager</title>"
        << "<style>"
        << "body{font-family:Inter,Segoe UI,Arial,sans-serif;margin:0;background:#f4f7fb;color:#1f2937;}"
@@ -505,37 +757,18 @@ static std::string pageHTML(const std::string& message = "") {
     }
 
     os << "<div class='card'><h3>Current portfolio</h3>";
-    os << portfolioTableHTML(g_portfolio);
-    
-    const double expectedReturn = g_portfolio.expectedReturn();
-    bool hasVolatility = false;
-    double volatility = 0.0;
-    const auto assetCount = g_portfolio.assetOrder().size();
-    if (g_has_last_corr && hasCompatibleMatrixSize(g_last_corr, assetCount)) {
-        volatility = g_portfolio.volatilityApprox(g_last_corr);
-        hasVolatility = true;
-    }
-
-    os << "<div class='metrics'>"
-       << "<div class='metric'><b>Total value</b><br/>" << fmt(g_portfolio.totalValue(), 2) << "</div>"
-       << "<div class='metric'><b>Expected return</b><br/>" << fmtPercent(expectedReturn, 2) << "</div>"
-       << "<div class='metric'><b>Volatility</b><br/>"
-       << (hasVolatility ? fmtPercent(volatility, 2) : std::string("N/A (compute metrics first)"))
-       << "</div>"
-       << "</div>";
-    os << orderHTML(g_portfolio);
-    os << weightsHTML(g_portfolio);
-    os << riskBreakdownHTML(g_portfolio, g_last_corr, g_has_last_corr && hasCompatibleMatrixSize(g_last_corr, assetCount));
+    os << state->portfolioHtml;
     os << "</div>";
 
-    if (g_has_last_corr) {
-        os << correlationMatrixHTML(g_last_corr, g_last_corr_labels, g_last_corr_source);
-    }
-    os << whatIfResultHTML();
-    os << optimizationResultHTML();
+    os << jobsHTML(jobs);
+    os << state->correlationHtml;
+    os << whatIfResultHTML(*state);
+    os << optimizationResultHTML(*state);
+    os << rollingCorrelationHTML(*state);
 
     os << "<div class='grid'>";
-    os << "<div class='card'><h3>Add position (Yahoo Finance)</h3>"
+    const std::string sourceName = htmlEscape(marketDataSource()->name());
+    os << "<div class='card'><h3>Add position (" << sourceName << ")</h3>"
        << "<form action='/add_yahoo' method='get'>"
        << "Ticker: <input name='ticker' placeholder='AAPL'/> "
        << "Qty: <input name='qty' placeholder='10'/> "
@@ -560,10 +793,39 @@ static std::string pageHTML(const std::string& message = "") {
        << "</form></div>";
 
     // Metrics auto
-    os << "<div class='card'><h3>Metrics (AUTO correlation from Yahoo)</h3>"
+    os << "<div class='card'><h3>Metrics (AUTO correlation from " << sourceName << ")</h3>"
        << "<form action='/metrics_auto' method='get'>"
+       << "Missing dates: <select name='missing'>"
+       << "<option value='intersection'>Common dates only</option>"
+       << "<option value='pairwise'>Pairwise complete</option>"
+       << "</select> "
        << "<button type='submit'>Compute auto corr + volatility</button>"
-       << "</form></div>";
+       << "</form>";
+    if (dynamic_cast<YahooMarketData*>(marketDataSource().get())) {
+        const HistoryCache::Stats cs = yahooHistoryCache().stats();
+        os << "<p class='muted'>History cache: " << cs.entries << " entries, " << cs.hits << " hits, "
+           << cs.misses << " misses, " << cs.coalesced << " coalesced</p>";
+        if (const auto store = yahooHistoryStore()) {
+            os << "<p class='muted'>History store: " << htmlEscape(store->directory()) << "</p>";
+        }
+    }
+    os << "</div>";
+
+    // Rolling correlation
+    os << "<div class='card'><h3>Rolling correlation</h3>"
+       << "<form action='/rolling_corr' method='get'>"
+       << "A: <input name='a' placeholder='" << htmlEscape(order.size() > 0 ? order[0] : "AAPL") << "'/> "
+       << "B: <input name='b' placeholder='" << htmlEscape(order.size() > 1 ? order[1] : "MSFT") << "'/> "
+       << "Window (days): <input name='window' placeholder='60'/> "
+       << "History: <select name='range'>"
+       << "<option value='2y'>2 years</option>"
+       << "<option value='5y' selected>5 years</option>"
+       << "<option value='10y'>10 years</option>"
+       << "</select> "
+       << "<button type='submit'>Plot</button>"
+       << "</form>"
+       << "<p class='muted'>Computed once for every pair of the portfolio; changing A/B reuses it.</p>"
+       << "</div>";
 
     // Metrics manual corr (to satisfy requirement "corr fourni")
     os << "<div class='card'><h3>Metrics (MANUAL correlation matrix)</h3>"
@@ -571,8 +833,7 @@ static std::string pageHTML(const std::string& message = "") {
        << "<p>Paste matrix (rows separated by newline, values separated by spaces or commas). "
        << "Order = " << htmlEscape([&](){
             std::ostringstream tmp;
-            auto ord = g_portfolio.assetOrder();
-            for (std::size_t i=0;i<ord.size();++i) tmp<<ord[i]<<(i+1==ord.size()?"":", ");
+            for (std::size_t i=0;i<order.size();++i) tmp<<order[i]<<(i+1==order.size()?"":", ");
             return tmp.str();
           }()) << "</p>"
        << "<textarea name='matrix' rows='6' placeholder='1 0.2\n0.2 1'></textarea><br/>"
@@ -622,16 +883,388 @@ static std::string pageHTML(const std::string& message = "") {
     return os.str();
 }
 
+struct OptimizeRequest {
+    std::string objective = "min_variance";
+    double targetReturn = -1.0;   // < 0 : pas de contrainte
+    double maxVol = -1.0;
+    double lambda = 0.5;
+};
+
+// 3500 candidats calculés sur une copie de l'instantané, sans verrou :
+// les autres requêtes continuent de lire et d'écrire pendant ce temps
+static std::string optimizeJob(const std::shared_ptr<const UiState>& current, const OptimizeRequest& opt, JobContext& ctx) {
+    const Portfolio portfolio = current->portfolio.copy();
+    const ValidatedCorrelation corr = current->lastCorr;
+    const auto& names = current->order;
+    const std::size_t n = names.size();   // >= 2 et corrélation compatible : vérifié à la soumission
+
+    const PortfolioSnapshot& snap = portfolio.snapshot();
+    const double* mu = snap.mu.data();
+    const double* sigma = snap.sigma.data();
+    const std::vector<double> currentW(snap.weight.begin(), snap.weight.end());
+
+    PortfolioPoint now;
+    now.weights = currentW;
+    now.expectedReturn = expectedReturnFromWeights(currentW, mu);
+    now.volatility = volatilityFromWeights(currentW, sigma, corr.matrix());
+    now.score = now.expectedReturn - opt.lambda * now.volatility;
+
+    std::vector<PortfolioPoint> candidates;
+    candidates.reserve(3500);
+    candidates.push_back(now);
+
+    std::uint64_t rng = 0xC0FFEE1234ULL;
+    for (int k = 0; k < 3500; ++k) {
+        if (k % 250 == 0) {
+            ctx.checkCancelled();
+            ctx.progress(0.9 * k / 3500.0);
+        }
+        auto w = randomLongOnlyWeights(n, rng);
+        PortfolioPoint p;
+        p.weights = w;
+        p.expectedReturn = expectedReturnFromWeights(w, mu);
+        p.volatility = volatilityFromWeights(w, sigma, corr.matrix());
+        p.score = p.expectedReturn - opt.lambda * p.volatility;
+        candidates.push_back(p);
+    }
+
+    auto isEligible = [&](const PortfolioPoint& p) {
+        if (opt.targetReturn >= 0.0 && p.expectedReturn < opt.targetReturn) return false;
+        if (opt.maxVol > 0.0 && p.volatility > opt.maxVol) return false;
+        return true;
+    };
+
+    PortfolioPoint best;
+    bool bestSet = false;
+
+    for (const auto& p : candidates) {
+        if (!isEligible(p)) continue;
+        if (!bestSet) {
+            best = p;
+            bestSet = true;
+            continue;
+        }
+
+        if (opt.objective == "max_return") {
+            if (p.expectedReturn > best.expectedReturn) best = p;
+        } else if (opt.objective == "max_score") {
+            if (p.score > best.score) best = p;
+        } else { // min_variance
+            if (p.volatility < best.volatility) best = p;
+        }
+    }
+
+    if (!bestSet) {
+        throw std::invalid_argument("No candidate portfolio satisfies selected constraints.");
+    }
+
+    auto result = std::make_shared<OptimizationResult>();
+    result->objective = opt.objective;
+    result->names = names;
+    result->current = now;
+    result->best = best;
+    result->candidates = candidates.size();
+
+    std::ostringstream html;
+    html << "<p><b>Objective:</b> " << htmlEscape(opt.objective) << "</p>";
+    html << "<p><b>Current:</b> return=" << fmtPercent(now.expectedReturn, 2)
+         << " | vol=" << fmtPercent(now.volatility, 2) << "</p>";
+    html << "<p><b>Best candidate:</b> return=" << fmtPercent(best.expectedReturn, 2)
+         << " | vol=" << fmtPercent(best.volatility, 2)
+         << " | score=" << fmt(best.score, 4) << "</p>";
+    html << "<p><b>Weights:</b><br/>";
+    for (std::size_t i = 0; i < n; ++i) {
+        html << htmlEscape(names[i]) << " : " << fmtPercent(best.weights[i], 2) << "<br/>";
+    }
+    html << "</p>";
+    html << optimizationChartSVG(candidates, now, best, opt.objective);
+
+    // publié seulement si portefeuille et corrélation n'ont pas bougé pendant le calcul
+    ctx.checkCancelled();
+    const std::string fragment = html.str();
+    updateState([&](UiState& state) {
+        if (state.revision != current->revision) {
+            throw std::runtime_error("Portfolio or correlation changed during optimization; run it again.");
+        }
+        state.optimizationHtml = fragment;
+        state.optimization = result;
+    });
+    return std::string("Optimization computed.");
+}
+
+// Historiques (Yahoo : fetch concurrent, cache d'abord), validation unique puis publication
+static std::string autoMetricsJob(const std::vector<std::string>& tickers, const AlignOptions& align, JobContext& ctx) {
+    const std::shared_ptr<MarketDataSource> source = marketDataSource();
+    std::vector<TickerHistory> fetched = source->histories(tickers);
+    ctx.checkCancelled();
+    ctx.progress(0.6);
+
+    // échecs rapportés ticker par ticker
+    std::vector<std::shared_ptr<const PriceHistory>> histories;
+    std::ostringstream failures;
+    std::size_t failed = 0;
+    for (const auto& f : fetched) {
+        if (f.ok()) {
+            histories.push_back(f.history);
+            continue;
+        }
+        ++failed;
+        failures << " " << f.ticker << " (" << f.error << ");";
+    }
+    if (failed > 0) {
+        std::ostringstream msg;
+        msg << "AUTO corr unavailable, " << failed << " of " << tickers.size() << " ticker(s) failed:" << failures.str();
+        throw std::runtime_error(msg.str());
+    }
+
+    ValidatedCorrelation corr(correlationMatrixFromHistories(histories, align));
+    ctx.checkCancelled();
+    ctx.progress(0.9);
+
+    double er=0, vol=0;
+    updateState([&](UiState& state) {
+        if (!hasCompatibleMatrix(corr, state.order)) {
+            throw std::runtime_error("Portfolio changed while fetching histories; compute metrics again.");
+        }
+        const RiskReport risk = state.portfolio.edit().riskReport(corr);
+        er = risk.expectedReturn;
+        vol = risk.volatility;
+        state.lastCorr = corr;
+        state.portfolio.edit().enableRiskTracking(state.lastCorr);
+        state.lastCorrSource = "AUTO / " + source->name();
+        state.hasLastCorr = true;
+        state.revision = ++g_revision;
+    });
+
+    std::ostringstream msg;
+    msg << "AUTO corr computed. Expected return=" << fmtPercent(er, 2) << " | Volatility=" << fmtPercent(vol, 2);
+    return msg.str();
+}
+
+// Paire A/B par label (vide : première paire disponible) ; invalid_argument si inconnue ou identique
+static std::pair<std::size_t, std::size_t> rollingPair(const RollingCorrelationSeries& rolling, const std::string& a,
+                                                       const std::string& b) {
+    auto pick = [&](const std::string& label, std::size_t fallback) {
+        if (label.empty()) return fallback;
+        const std::size_t i = rolling.indexOf(label);
+        if (i == rolling.series()) throw std::invalid_argument("Unknown ticker in portfolio: " + label);
+        return i;
+    };
+    const std::size_t i = pick(a, 0);
+    const std::size_t j = pick(b, i == 1 ? 0 : 1);
+    if (i == j) throw std::invalid_argument("choose two different tickers.");
+    return {i, j};
+}
+
+// Historiques longs (jusqu'à 10 ans) et toutes les paires en une passe, hors threads httplib
+static std::string rollingCorrelationJob(const std::vector<std::string>& tickers, const std::string& range,
+                                         std::size_t window, const std::string& labelA, const std::string& labelB,
+                                         JobContext& ctx) {
+    const std::shared_ptr<MarketDataSource> source = marketDataSource();
+    std::vector<TickerHistory> fetched = source->histories(tickers, range);
+    ctx.checkCancelled();
+    ctx.progress(0.6);
+
+    std::vector<const PriceHistory*> ptrs;
+    std::string failures;
+    for (const auto& f : fetched) {
+        if (f.ok()) ptrs.push_back(f.history.get());
+        else failures += " " + f.ticker + " (" + f.error + ");";
+    }
+    if (!failures.empty()) throw std::runtime_error("rolling correlation unavailable:" + failures);
+
+    RollingCorrelationOptions options;
+    options.window = window;
+    const auto rolling = std::make_shared<const RollingCorrelationSeries>(
+        RollingCorrelationSeries::compute(AlignedReturns::join(ptrs), options));
+    const auto ab = rollingPair(*rolling, labelA, labelB);
+    ctx.checkCancelled();
+
+    updateState([&](UiState& state) {
+        if (state.order != tickers) {
+            throw std::runtime_error("Portfolio changed while computing rolling correlation; run it again.");
+        }
+        state.rolling = rolling;
+        state.rollingRange = range;
+        state.rollingA = ab.first;
+        state.rollingB = ab.second;
+    });
+    return "Rolling correlation " + rolling->labels()[ab.first] + " / " + rolling->labels()[ab.second] + " plotted.";
+}
+
+// Paramètres de /optimize (pages et API) ; invalid_argument si une valeur est invalide
+static OptimizeRequest parseOptimizeRequest(const httplib::Request& req) {
+    OptimizeRequest opt;
+    if (req.has_param("objective")) opt.objective = req.get_param_value("objective");
+    if (req.has_param("target_return") && !req.get_param_value("target_return").empty()) {
+        if (!parseDouble(req.get_param_value("target_return"), opt.targetReturn)) {
+            throw std::invalid_argument("Invalid target_return.");
+        }
+    }
+    if (req.has_param("max_vol") && !req.get_param_value("max_vol").empty()) {
+        if (!parseDouble(req.get_param_value("max_vol"), opt.maxVol) || opt.maxVol <= 0.0) {
+            throw std::invalid_argument("Invalid max_vol.");
+        }
+    }
+    if (req.has_param("lambda") && !req.get_param_value("lambda").empty()) {
+        if (!parseDouble(req.get_param_value("lambda"), opt.lambda) || opt.lambda < 0.0) {
+            throw std::invalid_argument("Invalid lambda.");
+        }
+    }
+    return opt;
+}
+
+// Préconditions vérifiées à la soumission, calcul dans un job
+static JobQueue::Submission submitOptimization(const OptimizeRequest& opt) {
+    const std::shared_ptr<const UiState> current = loadState();
+    if (current->order.size() < 2) throw std::invalid_argument("Need at least 2 assets to optimize.");
+    if (!(current->hasLastCorr && hasCompatibleMatrix(current->lastCorr, current->order))) {
+        throw std::invalid_argument("Compute correlation matrix first (auto or manual) before optimization.");
+    }
+
+    // même portefeuille, même corrélation, mêmes paramètres : même job
+    std::ostringstream key;
+    key.precision(17);
+    key << "optimize|" << current->revision << "|" << opt.objective << "|" << opt.targetReturn << "|"
+        << opt.maxVol << "|" << opt.lambda;
+    return jobQueue().submit(key.str(), [current, opt](JobContext& ctx) { return optimizeJob(current, opt, ctx); });
+}
+
+static AlignOptions parseAlignOptions(const httplib::Request& req) {
+    AlignOptions align;
+    if (req.has_param("missing") && req.get_param_value("missing") == "pairwise") {
+        align.missing = MissingReturns::PairwiseComplete;
+    }
+    return align;
+}
+
+static JobQueue::Submission submitAutoMetrics(const AlignOptions& align) {
+    const std::shared_ptr<const UiState> current = loadState();
+    if (current->order.empty()) throw std::invalid_argument("Portfolio empty.");
+    const std::string key = "metrics_auto|" + std::to_string(current->revision) + "|" +
+                            (align.missing == MissingReturns::PairwiseComplete ? "pairwise" : "intersection");
+    const std::vector<std::string> tickers = current->order;
+    return jobQueue().submit(key, [tickers, align](JobContext& ctx) { return autoMetricsJob(tickers, align, ctx); });
+}
+
+// API JSON : réponses écrites par JsonWriter dans un tampon par thread, réutilisé
+// d'une requête à l'autre ; aucune méthode de Portfolio, seulement la vue de l'instantané.
+template <typename Fill>
+static void sendJson(httplib::Response& res, int status, Fill fill) {
+    thread_local std::string buffer;
+    buffer.clear();
+    JsonWriter json(buffer);
+    fill(json);
+    res.status = status;
+    res.set_content(buffer, "application/json");
+}
+
+static void sendJsonError(httplib::Response& res, int status, const std::string& message) {
+    sendJson(res, status, [&](JsonWriter& json) { json.beginObject().field("error", message).endObject(); });
+}
+
+// 400 entrée invalide, 404 inconnu, 409 état incompatible, 503 file pleine
+static httplib::Server::Handler apiRoute(httplib::Server::Handler handler) {
+    return [handler](const httplib::Request& req, httplib::Response& res) {
+        try {
+            handler(req, res);
+        } catch (const JobQueueFull& e) {
+            sendJsonError(res, 503, e.what());
+        } catch (const std::invalid_argument& e) {
+            sendJsonError(res, 400, e.what());
+        } catch (const std::out_of_range& e) {
+            sendJsonError(res, 404, e.what());
+        } catch (const std::exception& e) {
+            sendJsonError(res, 500, e.what());
+        }
+    };
+}
+
+static void writeJob(JsonWriter& json, const JobInfo& job) {
+    json.beginObject()
+        .field("id", job.id)
+        .field("job", jobKind(job))
+        .field("status", jobStatusName(job.status))
+        .field("progress", job.progress)
+        .field("result", job.result)
+        .field("error", job.error)
+        .endObject();
+}
+
+static void sendSubmission(httplib::Response& res, const JobQueue::Submission& submitted) {
+    const std::optional<JobInfo> job = jobQueue().info(submitted.id);
+    sendJson(res, 202, [&](JsonWriter& json) {
+        json.beginObject().field("coalesced", submitted.coalesced).key("job");
+        if (job) writeJob(json, *job);
+        else json.null();
+        json.endObject();
+    });
+}
+
+static void writePositions(JsonWriter& json, const UiState& state) {
+    const PortfolioSnapshot& s = state.snapshot;
+    json.beginArray();
+    for (std::size_t i = 0; i < s.n; ++i) {
+        json.beginObject()
+            .field("name", state.order[i])
+            .field("quantity", s.qty[i])
+            .field("price", s.price[i])
+            .field("mu", s.mu[i])
+            .field("sigma", s.sigma[i])
+            .field("value", s.value[i])
+            .field("weight", s.weight[i])
+            .endObject();
+    }
+    json.endArray();
+}
+
+// {"name": share, ...} ; null si la variance est nulle
+static void writeRiskShares(JsonWriter& json, const std::vector<std::string>& names,
+                            const std::vector<double>& contributions, double variance) {
+    json.beginObject();
+    for (std::size_t i = 0; i < names.size() && i < contributions.size(); ++i) {
+        json.key(names[i]);
+        if (variance > 0.0) json.value(contributions[i] / variance);
+        else json.null();
+    }
+    json.endObject();
+}
+
+static void writePoint(JsonWriter& json, const PortfolioPoint& p, const std::vector<std::string>& names) {
+    json.beginObject()
+        .field("expectedReturn", p.expectedReturn)
+        .field("volatility", p.volatility)
+        .field("score", p.score)
+        .key("weights")
+        .beginObject();
+    for (std::size_t i = 0; i < names.size() && i < p.weights.size(); ++i) json.field(names[i], p.weights[i]);
+    json.endObject().endObject();
+}
+
 // main
-int main() {
+int main(int argc, char** argv) {
     httplib::Server svr;
 
+    // --data=yahoo|file:<dir>|memory, sinon MARKET_DATA, sinon Yahoo
+    try {
+        std::cout << "Market data: " << configureMarketDataSource(argc, argv)->name() << "\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    // warm start : historiques relus depuis le disque au redémarrage
+    if (!yahooHistoryStore()) setYahooHistoryStore(std::make_shared<HistoryStore>("history_store"));
+
+    // premier instantané : vue du portefeuille vide
+    updateState([](UiState&) {});
+
     // Home
     svr.Get("/", [](const httplib::Request&, httplib::Response& res) {
         res.set_content(pageHTML(), "text/html; charset=utf-8");
     });
 
-    // Add Yahoo
+    // Add from market data
     svr.Get("/add_yahoo", [](const httplib::Request& req, httplib::Response& res) {
         try {
             if (!req.has_param("ticker") || !req.has_param("qty")) {
@@ -646,16 +1279,21 @@ int main() {
                 return;
             }
 
-            Asset a = fetchAssetFromYahoo(ticker);
-
-            {
-                std::lock_guard<std::mutex> lock(g_mutex);
-                g_portfolio.addPosition(a, qty);
-                g_has_last_optimization = false;
-                g_last_optimization_html.clear();
-            }
-
-            res.set_content(pageHTML("Added " + ticker + " from Yahoo."), "text/html; charset=utf-8");
+            // Yahoo : historique servi par le cache (TTL), metrics_auto le réutilise
+            auto history = marketDataSource()->history(HistoryKey{ticker});
+            // Actif propre à l'UI, hors AssetRegistry : aucune écriture partagée ne peut
+            // modifier un état déjà publié. Ticker déjà détenu : le nouveau fetch (prix,
+            // mu, sigma) remplace l'actif dans la copie privée de l'écrivain.
+            const Asset a = history->toAsset();
+
+            updateState([&](UiState& state) {
+                Portfolio& p = state.portfolio.edit();
+                if (p.find(a.id())) p.replaceAsset(a);
+                p.addPosition(a, qty);
+                portfolioChanged(state);
+            });
+
+            res.set_content(pageHTML("Added " + ticker + " from " + marketDataSource()->name() + "."), "text/html; charset=utf-8");
         } catch (const std::exception& e) {
             res.set_content(pageHTML(std::string("Error: ") + e.what()), "text/html; charset=utf-8");
         }
@@ -683,12 +1321,10 @@ int main() {
             }
 
             Asset a(name, price, mu, sigma);
-            {
-                std::lock_guard<std::mutex> lock(g_mutex);
-                g_portfolio.addPosition(a, qty);
-                g_has_last_optimization = false;
-                g_last_optimization_html.clear();
-            }
+            updateState([&](UiState& state) {
+                state.portfolio.edit().addPosition(a, qty);
+                portfolioChanged(state);
+            });
 
             res.set_content(pageHTML("Added " + name + " manually."), "text/html; charset=utf-8");
         } catch (const std::exception& e) {
@@ -710,12 +1346,10 @@ int main() {
                 return;
             }
 
-            {
-                std::lock_guard<std::mutex> lock(g_mutex);
-                g_portfolio.removePosition(name, qty);
-                g_has_last_optimization = false;
-                g_last_optimization_html.clear();
-            }
+            updateState([&](UiState& state) {
+                state.portfolio.edit().removePosition(name, qty);
+                portfolioChanged(state);
+            });
 
             res.set_content(pageHTML("Removed " + std::to_string(qty) + " of " + name + "."), "text/html; charset=utf-8");
         } catch (const std::exception& e) {
@@ -739,31 +1373,19 @@ int main() {
             }
 
             {
-                std::lock_guard<std::mutex> lock(g_mutex);
-                Portfolio simulated = g_portfolio;
-                if (qtyDelta > 0.0) {
-                    const auto& pos = simulated[name];
-                    simulated.addPosition(pos.asset, qtyDelta);
-                } else {
-                    simulated.removePosition(name, std::fabs(qtyDelta));
-                }
-
-                const double simER = simulated.expectedReturn();
+                const WhatIfResult sim = simulateWhatIf(*loadState(), name, qtyDelta);
                 std::ostringstream block;
                 block << "<p><b>Scenario:</b> " << htmlEscape(name) << " qty delta = " << qtyDelta << "</p>"
-                      << "<p><b>Expected return:</b> " << fmtPercent(simER, 2) << "</p>";
-
-                const auto n = simulated.assetOrder().size();
-                if (g_has_last_corr && hasCompatibleMatrixSize(g_last_corr, n)) {
-                    const double simVol = simulated.volatilityApprox(g_last_corr);
-                    block << "<p><b>Volatility:</b> " << fmtPercent(simVol, 2) << "</p>";
-                    block << riskBreakdownHTML(simulated, g_last_corr, true);
+                      << "<p><b>Expected return:</b> " << fmtPercent(sim.expectedReturn, 2) << "</p>";
+                if (sim.hasRisk) {
+                    block << "<p><b>Volatility:</b> " << fmtPercent(sim.volatility, 2) << "</p>";
+                    block << riskSharesHTML(sim.names, sim.contributions, sim.variance);
                 } else {
                     block << "<p><b>Volatility:</b> N/A (compute metrics first).</p>";
                 }
 
-                g_last_what_if_html = block.str();
-                g_has_last_what_if = true;
+                const std::string html = block.str();
+                updateState([&](UiState& state) { state.whatIfHtml = html; });
             }
 
             res.set_content(pageHTML("What-if simulation computed."), "text/html; charset=utf-8");
@@ -782,18 +1404,14 @@ int main() {
 
             Portfolio imported = portfolioFromCSVText(req.get_param_value("csv_text"));
 
-            {
-                std::lock_guard<std::mutex> lock(g_mutex);
-                g_portfolio = imported;
-                g_has_last_corr = false;
-                g_last_corr.clear();
-                g_last_corr_labels.clear();
-                g_last_corr_source.clear();
-                g_has_last_what_if = false;
-                g_last_what_if_html.clear();
-                g_has_last_optimization = false;
-                g_last_optimization_html.clear();
-            }
+            updateState([&](UiState& state) {
+                state.portfolio.edit() = imported;
+                state.hasLastCorr = false;
+                state.lastCorr = ValidatedCorrelation();
+                state.lastCorrSource.clear();
+                state.whatIfHtml.clear();
+                portfolioChanged(state);
+            });
 
             res.set_content(pageHTML("Portfolio imported from CSV (Excel-compatible)."), "text/html; charset=utf-8");
         } catch (const std::exception& e) {
@@ -804,12 +1422,13 @@ int main() {
     // CSV export
     svr.Get("/export_csv", [](const httplib::Request&, httplib::Response& res) {
         try {
-            std::string csv;
-            {
-                std::lock_guard<std::mutex> lock(g_mutex);
-                const bool corrOk = g_has_last_corr && hasCompatibleMatrixSize(g_last_corr, g_portfolio.assetOrder().size());
-                csv = exportPortfolioCSV(g_portfolio, g_last_corr, corrOk);
+            const std::shared_ptr<const UiState> current = loadState();
+            const Portfolio portfolio = current->portfolio.copy();
+            std::optional<RiskReport> risk;
+            if (current->hasLastCorr && hasCompatibleMatrix(current->lastCorr, current->order)) {
+                risk = portfolio.riskReport(current->lastCorr);
             }
+            const std::string csv = exportPortfolioCSV(portfolio, risk ? &*risk : nullptr);
             res.set_header("Content-Disposition", "attachment; filename=portfolio_export.csv");
             res.set_content(csv, "text/csv; charset=utf-8");
         } catch (const std::exception& e) {
@@ -820,156 +1439,99 @@ int main() {
     // Portfolio optimization
     svr.Get("/optimize", [](const httplib::Request& req, httplib::Response& res) {
         try {
-            std::string objective = req.has_param("objective") ? req.get_param_value("objective") : "min_variance";
-
-            double targetReturn = -1.0;
-            if (req.has_param("target_return") && !req.get_param_value("target_return").empty()) {
-                if (!parseDouble(req.get_param_value("target_return"), targetReturn)) {
-                    res.set_content(pageHTML("Invalid target_return."), "text/html; charset=utf-8");
-                    return;
-                }
-            }
-
-            double maxVol = -1.0;
-            if (req.has_param("max_vol") && !req.get_param_value("max_vol").empty()) {
-                if (!parseDouble(req.get_param_value("max_vol"), maxVol) || maxVol <= 0.0) {
-                    res.set_content(pageHTML("Invalid max_vol."), "text/html; charset=utf-8");
-                    return;
-                }
-            }
-
-            double lambda = 0.5;
-            if (req.has_param("lambda") && !req.get_param_value("lambda").empty()) {
-                if (!parseDouble(req.get_param_value("lambda"), lambda) || lambda < 0.0) {
-                    res.set_content(pageHTML("Invalid lambda."), "text/html; charset=utf-8");
-                    return;
-                }
-            }
-
-            {
-                std::lock_guard<std::mutex> lock(g_mutex);
-                const auto names = g_portfolio.assetOrder();
-                const std::size_t n = names.size();
-                if (n < 2) throw std::invalid_argument("Need at least 2 assets to optimize.");
-                if (!(g_has_last_corr && hasCompatibleMatrixSize(g_last_corr, n))) {
-                    throw std::invalid_argument("Compute correlation matrix first (auto or manual) before optimization.");
-                }
-
-                std::vector<double> mu(n, 0.0), sigma(n, 0.0), currentW(n, 0.0);
-                const double total = g_portfolio.totalValue();
-                for (std::size_t i = 0; i < n; ++i) {
-                    const auto& pos = g_portfolio[names[i]];
-                    mu[i] = pos.asset.expectedReturn();
-                    sigma[i] = pos.asset.volatility();
-                    currentW[i] = total > 0.0 ? pos.value() / total : 0.0;
-                }
-
-                PortfolioPoint current;
-                current.weights = currentW;
-                current.expectedReturn = expectedReturnFromWeights(currentW, mu);
-                current.volatility = volatilityFromWeights(currentW, sigma, g_last_corr);
-                current.score = current.expectedReturn - lambda * current.volatility;
-
-                std::vector<PortfolioPoint> candidates;
-                candidates.reserve(3500);
-                candidates.push_back(current);
-
-                std::uint64_t rng = 0xC0FFEE1234ULL;
-                for (int k = 0; k < 3500; ++k) {
-                    auto w = randomLongOnlyWeights(n, rng);
-                    PortfolioPoint p;
-                    p.weights = w;
-                    p.expectedReturn = expectedReturnFromWeights(w, mu);
-                    p.volatility = volatilityFromWeights(w, sigma, g_last_corr);
-                    p.score = p.expectedReturn - lambda * p.volatility;
-                    candidates.push_back(p);
-                }
-
-                auto isEligible = [&](const PortfolioPoint& p) {
-                    if (targetReturn >= 0.0 && p.expectedReturn < targetReturn) return false;
-                    if (maxVol > 0.0 && p.volatility > maxVol) return false;
-                    return true;
-                };
-
-                PortfolioPoint best;
-                bool bestSet = false;
-
-                for (const auto& p : candidates) {
-                    if (!isEligible(p)) continue;
-                    if (!bestSet) {
-                        best = p;
-                        bestSet = true;
-                        continue;
-                    }
-
-                    if (objective == "max_return") {
-                        if (p.expectedReturn > best.expectedReturn) best = p;
-                    } else if (objective == "max_score") {
-                        if (p.score > best.score) best = p;
-                    } else { // min_variance
-                        if (p.volatility < best.volatility) best = p;
-                    }
-                }
-
-                if (!bestSet) {
-                    throw std::invalid_argument("No candidate portfolio satisfies selected constraints.");
-                }
-
-                std::ostringstream html;
-                html << "<p><b>Objective:</b> " << htmlEscape(objective) << "</p>";
-                html << "<p><b>Current:</b> return=" << fmtPercent(current.expectedReturn, 2)
-                     << " | vol=" << fmtPercent(current.volatility, 2) << "</p>";
-                html << "<p><b>Best candidate:</b> return=" << fmtPercent(best.expectedReturn, 2)
-                     << " | vol=" << fmtPercent(best.volatility, 2)
-                     << " | score=" << fmt(best.score, 4) << "</p>";
-                html << "<p><b>Weights:</b><br/>";
-                for (std::size_t i = 0; i < n; ++i) {
-                    html << htmlEscape(names[i]) << " : " << fmtPercent(best.weights[i], 2) << "<br/>";
-                }
-                html << "</p>";
-                html << optimizationChartSVG(candidates, current, best, objective);
-
-                g_last_optimization_html = html.str();
-                g_has_last_optimization = true;
-            }
-
-            res.set_content(pageHTML("Optimization computed."), "text/html; charset=utf-8");
+            const std::string msg = jobMessage("Optimization", submitOptimization(parseOptimizeRequest(req)));
+            res.set_content(pageHTML(msg), "text/html; charset=utf-8");
         } catch (const std::exception& e) {
             res.set_content(pageHTML(std::string("Error: ") + e.what()), "text/html; charset=utf-8");
         }
     });
 
     // Metrics auto correlation
-    svr.Get("/metrics_auto", [](const httplib::Request&, httplib::Response& res) {
+    svr.Get("/metrics_auto", [](const httplib::Request& req, httplib::Response& res) {
         try {
-            std::vector<std::string> tickers;
-            {
-                std::lock_guard<std::mutex> lock(g_mutex);
-                tickers = g_portfolio.assetOrder();
-            }
-            if (tickers.empty()) {
+            if (loadState()->order.empty()) {
                 res.set_content(pageHTML("Portfolio empty."), "text/html; charset=utf-8");
                 return;
             }
+            const std::string msg = jobMessage("AUTO correlation", submitAutoMetrics(parseAlignOptions(req)));
+            res.set_content(pageHTML(msg), "text/html; charset=utf-8");
+        } catch (const std::exception& e) {
+            res.set_content(pageHTML(std::string("Error: ") + e.what()), "text/html; charset=utf-8");
+        }
+    });
 
-            auto corr = correlationMatrixFromYahoo(tickers);
+    // État d'un job (JSON) : {"id","job","status","progress","result","error"}
+    svr.Get("/job", [](const httplib::Request& req, httplib::Response& res) {
+        std::uint64_t id = 0;
+        std::optional<JobInfo> job;
+        if (req.has_param("id") && parseUnsigned(req.get_param_value("id"), id)) job = jobQueue().info(id);
+        if (!job) {
+            sendJsonError(res, 404, "unknown job");
+            return;
+        }
+        sendJson(res, 200, [&](JsonWriter& json) { writeJob(json, *job); });
+    });
 
-            double er=0, vol=0;
-            {
-                std::lock_guard<std::mutex> lock(g_mutex);
-                er = g_portfolio.expectedReturn();
-                vol = g_portfolio.volatilityApprox(corr);
-                g_last_corr = corr;
-                g_last_corr_labels = tickers;
-                g_last_corr_source = "AUTO / Yahoo";
-                g_has_last_corr = true;
+    svr.Get("/cancel_job", [](const httplib::Request& req, httplib::Response& res) {
+        std::uint64_t id = 0;
+        if (!req.has_param("id") || !parseUnsigned(req.get_param_value("id"), id) || id == 0) {
+            res.set_content(pageHTML("Error: invalid job id."), "text/html; charset=utf-8");
+            return;
+        }
+        const bool cancelled = jobQueue().cancel(id);
+        res.set_content(pageHTML(cancelled ? "Cancellation requested for job #" + std::to_string(id) + "."
+                                           : std::string("Error: job not found or already finished.")),
+                        "text/html; charset=utf-8");
+    });
+
+    // Rolling correlation : toutes les paires en une passe (job), graphique de la paire A/B
+    svr.Get("/rolling_corr", [](const httplib::Request& req, httplib::Response& res) {
+        try {
+            const std::shared_ptr<const UiState> current = loadState();
+            const std::vector<std::string>& tickers = current->order;
+            if (tickers.size() < 2) {
+                res.set_content(pageHTML("Error: rolling correlation needs at least 2 positions."), "text/html; charset=utf-8");
+                return;
             }
 
-            std::ostringstream msg;
-            msg << "AUTO corr computed. Expected return=" << fmtPercent(er, 2)
-                << " | Volatility=" << fmtPercent(vol, 2);
-            res.set_content(pageHTML(msg.str()), "text/html; charset=utf-8");
+            std::size_t window = 60;
+            if (req.has_param("window") && !trimCopy(req.get_param_value("window")).empty()) {
+                if (!parseUnsigned(trimCopy(req.get_param_value("window")), window) || window < 2 ||
+                    window > kMaxRollingWindow) {
+                    res.set_content(pageHTML("Error: window must be an integer between 2 and " +
+                                             std::to_string(kMaxRollingWindow) + "."),
+                                    "text/html; charset=utf-8");
+                    return;
+                }
+            }
+            std::string range = req.has_param("range") ? req.get_param_value("range") : "5y";
+            if (range != "2y" && range != "5y" && range != "10y") range = "5y";
+
+            const std::string labelA = req.has_param("a") ? trimCopy(req.get_param_value("a")) : "";
+            const std::string labelB = req.has_param("b") ? trimCopy(req.get_param_value("b")) : "";
+
+            // série déjà calculée pour ces tickers/plage/fenêtre : seul le choix de la paire change
+            if (current->rolling && current->rolling->labels() == tickers && current->rolling->window() == window &&
+                current->rollingRange == range) {
+                const std::shared_ptr<const RollingCorrelationSeries> rolling = current->rolling;
+                const auto ab = rollingPair(*rolling, labelA, labelB);
+                updateState([&](UiState& state) {
+                    state.rollingA = ab.first;
+                    state.rollingB = ab.second;
+                });
+                res.set_content(pageHTML("Rolling correlation " + rolling->labels()[ab.first] + " / " +
+                                         rolling->labels()[ab.second] + " plotted."),
+                                "text/html; charset=utf-8");
+                return;
+            }
 
+            std::string key = "rolling_corr|" + range + "|" + std::to_string(window);
+            for (const auto& t : tickers) key += "|" + t;
+            const std::vector<std::string> names = tickers;
+            const JobQueue::Submission job = jobQueue().submit(key, [names, range, window, labelA, labelB](JobContext& ctx) {
+                return rollingCorrelationJob(names, range, window, labelA, labelB, ctx);
+            });
+            res.set_content(pageHTML(jobMessage("Rolling correlation", job)), "text/html; charset=utf-8");
         } catch (const std::exception& e) {
             res.set_content(pageHTML(std::string("Error: ") + e.what()), "text/html; charset=utf-8");
         }
@@ -983,19 +1545,32 @@ int main() {
                 return;
             }
             std::string text = req.get_param_value("matrix");
-            auto M = parseMatrixText(text);
+            auto corr = CorrelationMatrix::fromRows(parseMatrixText(text));
 
-            double er=0, vol=0;
-            {
-                std::lock_guard<std::mutex> lock(g_mutex);
-                auto ord = g_portfolio.assetOrder();
-                er = g_portfolio.expectedReturn();
-                vol = g_portfolio.volatilityApprox(M); // => invalid_argument si dimension incorrecte (exigence)
-                g_last_corr = M;
-                g_last_corr_labels = ord;
-                g_last_corr_source = "MANUAL";
-                g_has_last_corr = true;
+            const std::vector<std::string> ord = loadState()->order;
+            // => invalid_argument si dimension incorrecte (exigence)
+            if (corr.size() != ord.size()) {
+                throw std::invalid_argument("varianceApprox: correlation matrix wrong size.");
             }
+            corr.setLabels(ord);
+            // mêmes contrôles que la saisie d'origine (symétrie, diagonale, [-1, 1]), hors publication ;
+            // pas de test PSD : une matrice saisie légèrement indéfinie reste acceptée
+            const ValidatedCorrelation handle(std::move(corr));
+
+            double er=0, vol=0;
+            updateState([&](UiState& state) {
+                if (!hasCompatibleMatrix(handle, state.order)) {
+                    throw std::runtime_error("Portfolio changed while validating the matrix; submit it again.");
+                }
+                const RiskReport risk = state.portfolio.edit().riskReport(handle);
+                er = risk.expectedReturn;
+                vol = risk.volatility;
+                state.lastCorr = handle;
+                state.portfolio.edit().enableRiskTracking(state.lastCorr);
+                state.lastCorrSource = "MANUAL";
+                state.hasLastCorr = true;
+                state.revision = ++g_revision;
+            });
 
             std::ostringstream msg;
             msg << "MANUAL corr used. Expected return=" << fmtPercent(er, 2)
@@ -1007,6 +1582,159 @@ int main() {
         }
     });
 
+    // API JSON /api/v1 : mêmes calculs que les pages, sans rendu HTML
+    svr.Get("/api/v1/portfolio", apiRoute([](const httplib::Request&, httplib::Response& res) {
+        const std::shared_ptr<const UiState> state = loadState();
+        sendJson(res, 200, [&](JsonWriter& json) {
+            json.beginObject()
+                .field("revision", state->revision)
+                .field("totalValue", state->snapshot.totalValue)
+                .field("expectedReturn", state->expectedReturn)
+                .key("volatility");
+            if (state->risk) json.value(state->risk->volatility);
+            else json.null();
+            json.key("correlation");
+            if (state->hasLastCorr) json.value(state->lastCorrSource);
+            else json.null();
+            json.key("positions");
+            writePositions(json, *state);
+            json.endObject();
+        });
+    }));
+
+    svr.Get("/api/v1/positions", apiRoute([](const httplib::Request&, httplib::Response& res) {
+        const std::shared_ptr<const UiState> state = loadState();
+        sendJson(res, 200, [&](JsonWriter& json) { writePositions(json, *state); });
+    }));
+
+    svr.Get("/api/v1/metrics", apiRoute([](const httplib::Request&, httplib::Response& res) {
+        const std::shared_ptr<const UiState> state = loadState();
+        if (!state->risk) {
+            sendJsonError(res, 409, "No correlation matrix for the current portfolio; POST /api/v1/metrics/auto first.");
+            return;
+        }
+        const RiskReport& risk = *state->risk;
+        sendJson(res, 200, [&](JsonWriter& json) {
+            json.beginObject()
+                .field("revision", state->revision)
+                .field("correlation", state->lastCorrSource)
+                .field("totalValue", risk.totalValue)
+                .field("expectedReturn", risk.expectedReturn)
+                .field("variance", risk.variance)
+                .field("volatility", risk.volatility)
+                .key("assets")
+                .beginArray();
+            for (std::size_t i = 0; i < state->order.size(); ++i) {
+                json.beginObject()
+                    .field("name", state->order[i])
+                    .field("weight", risk.weights[i])
+                    .field("marginal", risk.marginal[i])
+                    .field("contribution", risk.contributions[i])
+                    .field("riskShare", risk.riskShares[i])
+                    .endObject();
+            }
+            json.endArray().endObject();
+        });
+    }));
+
+    // ?missing=pairwise comme /metrics_auto ; 202 + job
+    svr.Post("/api/v1/metrics/auto", apiRoute([](const httplib::Request& req, httplib::Response& res) {
+        sendSubmission(res, submitAutoMetrics(parseAlignOptions(req)));
+    }));
+
+    svr.Get("/api/v1/correlation", apiRoute([](const httplib::Request&, httplib::Response& res) {
+        const std::shared_ptr<const UiState> state = loadState();
+        if (!state->hasLastCorr) {
+            sendJsonError(res, 404, "No correlation matrix computed.");
+            return;
+        }
+        const CorrelationMatrix& corr = state->lastCorr.matrix();
+        sendJson(res, 200, [&](JsonWriter& json) {
+            json.beginObject().field("source", state->lastCorrSource).key("labels").beginArray();
+            for (const auto& label : corr.labels()) json.value(label);
+            json.endArray().key("matrix").beginArray();
+            for (std::size_t i = 0; i < corr.size(); ++i) {
+                json.beginArray();
+                for (std::size_t j = 0; j < corr.size(); ++j) json.value(corr(i, j));
+                json.endArray();
+            }
+            json.endArray().endObject();
+        });
+    }));
+
+    svr.Get("/api/v1/what_if", apiRoute([](const httplib::Request& req, httplib::Response& res) {
+        double qtyDelta = 0.0;
+        if (!req.has_param("name") || !req.has_param("qty_delta")) throw std::invalid_argument("Missing name/qty_delta.");
+        if (!parseDouble(req.get_param_value("qty_delta"), qtyDelta) || qtyDelta == 0.0) {
+            throw std::invalid_argument("Invalid qty_delta (must be non-zero).");
+        }
+        const std::string name = req.get_param_value("name");
+        const WhatIfResult sim = simulateWhatIf(*loadState(), name, qtyDelta);
+        sendJson(res, 200, [&](JsonWriter& json) {
+            json.beginObject()
+                .field("name", name)
+                .field("qtyDelta", qtyDelta)
+                .field("totalValue", sim.totalValue)
+                .field("expectedReturn", sim.expectedReturn)
+                .key("volatility");
+            if (sim.hasRisk) json.value(sim.volatility);
+            else json.null();
+            json.key("riskShares");
+            if (sim.hasRisk) writeRiskShares(json, sim.names, sim.contributions, sim.variance);
+            else json.null();
+            json.endObject();
+        });
+    }));
+
+    // Paramètres de /optimize ; 202 + job, résultat ensuite sur GET /api/v1/optimization
+    svr.Post("/api/v1/optimize", apiRoute([](const httplib::Request& req, httplib::Response& res) {
+        sendSubmission(res, submitOptimization(parseOptimizeRequest(req)));
+    }));
+
+    svr.Get("/api/v1/optimization", apiRoute([](const httplib::Request&, httplib::Response& res) {
+        const std::shared_ptr<const UiState> state = loadState();
+        if (!state->optimization) {
+            sendJsonError(res, 404, "No optimization result for the current portfolio.");
+            return;
+        }
+        const OptimizationResult& r = *state->optimization;
+        sendJson(res, 200, [&](JsonWriter& json) {
+            json.beginObject()
+                .field("revision", state->revision)
+                .field("objective", r.objective)
+                .field("candidates", (std::uint64_t)r.candidates)
+                .key("current");
+            writePoint(json, r.current, r.names);
+            json.key("best");
+            writePoint(json, r.best, r.names);
+            json.endObject();
+        });
+    }));
+
+    svr.Get(R"(/api/v1/jobs/(\d+))", apiRoute([](const httplib::Request& req, httplib::Response& res) {
+        std::uint64_t id = 0;
+        const std::optional<JobInfo> job =
+            parseUnsigned(req.matches[1].str(), id) ? jobQueue().info(id) : std::nullopt;
+        if (!job) {
+            sendJsonError(res, 404, "unknown job");
+            return;
+        }
+        sendJson(res, 200, [&](JsonWriter& json) { writeJob(json, *job); });
+    }));
+
+    svr.Delete(R"(/api/v1/jobs/(\d+))", apiRoute([](const httplib::Request& req, httplib::Response& res) {
+        std::uint64_t id = 0;
+        if (!parseUnsigned(req.matches[1].str(), id) || !jobQueue().cancel(id)) {
+            sendJsonError(res, 409, "job not found or already finished");
+            return;
+        }
+        const std::optional<JobInfo> job = jobQueue().info(id);
+        sendJson(res, 200, [&](JsonWriter& json) {
+            if (job) writeJob(json, *job);
+            else json.null();
+        });
+    }));
+
     // Run server
     const char* host = "127.0.0.1";
     const int port = 8080;
@@ -0,0 +1,185 @@
+#ifndef YAHOO_MOCK_SERVER_HPP
+#define YAHOO_MOCK_SERVER_HPP
+
+#include "httplib.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Serveur local qui rejoue des réponses chart Yahoo : /v8/finance/chart/<TICKER>
+// renvoie le JSON enregistré pour ce ticker (en mémoire ou <dir>/<TICKER>.json), 404 sinon.
+// Pour une série donnée par setSeries, period1 restreint la réponse aux barres >= period1.
+// Compte les requêtes, les connexions distinctes (port client, pour le keep-alive) et le pic
+// de requêtes simultanées ; latence artificielle globale ou par ticker.
+class YahooMockServer {
+private:
+    httplib::Server server_;
+    std::thread thread_;
+    int port_ = 0;
+
+    std::mutex mutex_;
+    std::map<std::string, std::string> charts_;
+    std::map<std::string, std::pair<std::vector<std::int64_t>, std::vector<double>>> series_;
+    std::string lastTarget_;
+    std::string directory_;
+    std::set<int> clientPorts_;
+    std::map<std::string, int> latencyMs_;
+    int defaultLatencyMs_ = 0;
+    std::atomic<std::size_t> requests_{0};
+    std::atomic<std::size_t> inFlight_{0};
+    std::atomic<std::size_t> peakInFlight_{0};
+
+    int latencyFor(const std::string& ticker) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = latencyMs_.find(ticker);
+        return it != latencyMs_.end() ? it->second : defaultLatencyMs_;
+    }
+
+    bool lookup(const std::string& ticker, const httplib::Request& req, std::string& body) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        lastTarget_ = req.target;
+        auto series = series_.find(ticker);
+        if (series != series_.end() && req.has_param("period1")) {
+            const std::int64_t period1 = std::stoll(req.get_param_value("period1"));
+            const auto& [ts, closes] = series->second;
+            const std::size_t first = std::lower_bound(ts.begin(), ts.end(), period1) - ts.begin();
+            body = chartJson(std::vector<std::int64_t>(ts.begin() + (long)first, ts.end()),
+                             std::vector<double>(closes.begin() + (long)first, closes.end()));
+            return true;
+        }
+        auto it = charts_.find(ticker);
+        if (it != charts_.end()) {
+            body = it->second;
+            return true;
+        }
+        if (directory_.empty()) return false;
+        std::ifstream in(directory_ + "/" + ticker + ".json", std::ios::binary);
+        if (!in) return false;
+        std::ostringstream ss;
+        ss << in.rdbuf();
+        body = ss.str();
+        return true;
+    }
+
+public:
+    explicit YahooMockServer(std::string directory = "") : directory_(std::move(directory)) {
+        server_.Get(R"(/v8/finance/chart/([^/?]+))", [this](const httplib::Request& req, httplib::Response& res) {
+            ++requests_;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                clientPorts_.insert(req.remote_port);
+            }
+            const std::size_t now = ++inFlight_;
+            std::size_t peak = peakInFlight_.load();
+            while (now > peak && !peakInFlight_.compare_exchange_weak(peak, now)) {}
+            const int latency = latencyFor(req.matches[1]);
+            if (latency > 0) std::this_thread::sleep_for(std::chrono::milliseconds(latency));
+            --inFlight_;
+
+            std::string body;
+            if (!lookup(req.matches[1], req, body)) {
+                res.status = 404;
+                res.set_content("{\"chart\":{\"result\":null,\"error\":{\"code\":\"Not Found\"}}}", "application/json");
+                return;
+            }
+            res.set_content(body, "application/json");
+        });
+    }
+
+    ~YahooMockServer() { stop(); }
+
+    YahooMockServer(const YahooMockServer&) = delete;
+    YahooMockServer& operator=(const YahooMockServer&) = delete;
+
+    // port = 0 : port libre choisi par l'OS
+    int start(int port = 0) {
+        port_ = port == 0 ? server_.bind_to_any_port("127.0.0.1") : (server_.bind_to_port("127.0.0.1", port) ? port : -1);
+        if (port_ <= 0) throw std::runtime_error("YahooMockServer: cannot bind port.");
+        thread_ = std::thread([this] { server_.listen_after_bind(); });
+        server_.wait_until_ready();
+        return port_;
+    }
+
+    void stop() {
+        if (thread_.joinable()) {
+            server_.stop();
+            thread_.join();
+        }
+    }
+
+    int port() const { return port_; }
+    std::string url() const { return "http://127.0.0.1:" + std::to_string(port_); }
+
+    void setChart(const std::string& ticker, std::string json) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        charts_[ticker] = std::move(json);
+    }
+
+    void setSeries(const std::string& ticker, std::vector<std::int64_t> timestamps, std::vector<double> closes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        charts_[ticker] = chartJson(timestamps, closes);
+        series_[ticker] = {std::move(timestamps), std::move(closes)};
+    }
+
+    void setLatencyMs(int ms) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        defaultLatencyMs_ = ms;
+    }
+    void setLatencyMs(const std::string& ticker, int ms) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        latencyMs_[ticker] = ms;
+    }
+
+    std::size_t requestCount() const { return requests_.load(); }
+    std::size_t peakInFlight() const { return peakInFlight_.load(); }
+    std::string lastTarget() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return lastTarget_;
+    }
+    std::size_t connectionCount() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return clientPorts_.size();
+    }
+
+    // JSON chart minimal (timestamps + closes), même forme que la réponse Yahoo ;
+    // sans barre, Yahoo omet le tableau timestamp
+    static std::string chartJson(const std::vector<std::int64_t>& timestamps, const std::vector<double>& closes) {
+        std::ostringstream os;
+        os.precision(17);
+        os << "{\"chart\":{\"result\":[{\"meta\":{\"currency\":\"USD\"},";
+        if (timestamps.empty()) {
+            os << "\"indicators\":{\"quote\":[{}]}}],\"error\":null}}";
+            return os.str();
+        }
+        os << "\"timestamp\":[";
+        for (std::size_t i = 0; i < timestamps.size(); ++i) os << (i ? "," : "") << timestamps[i];
+        os << "],\"indicators\":{\"quote\":[{\"close\":[";
+        for (std::size_t i = 0; i < closes.size(); ++i) os << (i ? "," : "") << closes[i];
+        os << "]}]}}],\"error\":null}}";
+        return os.str();
+    }
+
+    // timestamps journaliers à partir de firstTimestamp
+    static std::vector<std::int64_t> dailyTimestamps(std::size_t n, std::int64_t firstTimestamp = 1700000000) {
+        std::vector<std::int64_t> ts(n);
+        for (std::size_t i = 0; i < n; ++i) ts[i] = firstTimestamp + static_cast<std::int64_t>(i) * 86400;
+        return ts;
+    }
+
+    static std::string chartJson(const std::vector<double>& closes, std::int64_t firstTimestamp = 1700000000) {
+        return chartJson(dailyTimestamps(closes.size(), firstTimestamp), closes);
+    }
+};
+
+#endif
@@ -1,11 +1,23 @@
 #include "Asset.hpp"
+#include "AssetRegistry.hpp"
+#include "CorrelationMatrix.hpp"
+#include "CovarianceEngine.hpp"
+#include "JobQueue.hpp"
+#include "JsonWriter.hpp"
+#include "OnlineStats.hpp"
 #include "Portfolio.hpp"
+#include "RiskKernels.hpp"
+#include "SymbolTable.hpp"
 
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <functional>
 #include <iostream>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 namespace {
@@ -39,6 +51,16 @@ void testAssetValidation() {
     expectThrows<std::invalid_argument>([&] { a.setPrice(-3.0); }, "setPrice negative");
     a.setPrice(120.0);
     expect(near(a.price(), 120.0), "setPrice update");
+
+    // copie = même enregistrement ; setPrice détache, setSharedPrice est vu par toutes les copies
+    Asset b = a;
+    expect(b.sharesRecordWith(a), "copy aliases the record");
+    b.setPrice(90.0);
+    expect(near(a.price(), 120.0) && near(b.price(), 90.0) && !b.sharesRecordWith(a), "setPrice on a copy detaches");
+    Asset c = a;
+    c.setSharedPrice(130.0);
+    expect(near(a.price(), 130.0) && c.sharesRecordWith(a), "setSharedPrice seen by every copy");
+    expectThrows<std::invalid_argument>([&] { c.setSharedPrice(-1.0); }, "setSharedPrice negative");
 }
 
 void testPositionAndAddRemoveValidation() {
@@ -146,6 +168,558 @@ void testVarianceContributions() {
     expect(near(sumContrib, totalVar), "variance contributions sum to total variance");
 }
 
+void testPackedCorrelationMatrix() {
+    Portfolio p = samplePortfolio();
+    const std::vector<std::vector<double>> rows = {
+        {1.0, 0.3},
+        {0.3, 1.0},
+    };
+
+    CorrelationMatrix corr = CorrelationMatrix::fromRows(rows, {"AAPL", "BOND"});
+    expect(corr.packedSize() == 3, "packed storage holds upper triangle only");
+    expect(near(corr(1, 0), 0.3) && near(corr(0, 1), 0.3), "symmetric access");
+    expect(near(p.varianceApprox(corr), p.varianceApprox(rows)), "packed and raw variance agree");
+
+    const auto c = p.varianceContributionsApprox(corr);
+    expect(near(c[0] + c[1], p.varianceApprox(corr)), "packed contributions sum to variance");
+
+    expectThrows<std::invalid_argument>(
+        [&] { CorrelationMatrix::fromRows({{1.0, 0.3}, {0.2, 1.0}}); }, "fromRows symmetry");
+    expectThrows<std::invalid_argument>(
+        [&] { (void)p.varianceApprox(CorrelationMatrix::fromRows(rows, {"BOND", "AAPL"})); },
+        "labels must follow asset order");
+}
+
+void testValidatedCorrelationHandle() {
+    Portfolio p = samplePortfolio();
+    const auto rows = std::vector<std::vector<double>>{{1.0, 0.3}, {0.3, 1.0}};
+
+    ValidatedCorrelation h(CorrelationMatrix::fromRows(rows, {"AAPL", "BOND"}), true);
+    expect(h.psdChecked() && h.size() == 2, "handle metadata");
+    expect(near(p.varianceApprox(h), p.varianceApprox(rows)), "handle and raw variance agree");
+
+    const ValidatedCorrelation copy = h;
+    expect(copy.shared() == h.shared(), "copies share the matrix");
+
+    expectThrows<std::invalid_argument>(
+        [] { ValidatedCorrelation(CorrelationMatrix::fromRows({{0.9, 0.0}, {0.0, 1.0}})); },
+        "handle validates diagonal");
+    // 3 actifs : corr(a,b) = corr(a,c) = 0.9, corr(b,c) = -0.9 => pas PSD
+    const auto notPsd = CorrelationMatrix::fromRows({{1.0, 0.9, 0.9}, {0.9, 1.0, -0.9}, {0.9, -0.9, 1.0}});
+    (void)ValidatedCorrelation(notPsd);
+    expectThrows<std::invalid_argument>([&] { ValidatedCorrelation(notPsd, true); }, "PSD check");
+}
+
+void testRiskReport() {
+    Portfolio p = samplePortfolio();
+    const auto rows = std::vector<std::vector<double>>{{1.0, 0.3}, {0.3, 1.0}};
+    const RiskReport r = p.riskReport(ValidatedCorrelation(CorrelationMatrix::fromRows(rows)));
+
+    expect(near(r.totalValue, p.totalValue()), "report total value");
+    expect(near(r.expectedReturn, p.expectedReturn()), "report expected return");
+    expect(near(r.variance, p.varianceApprox(rows)), "report variance");
+    expect(near(r.volatility, p.volatilityApprox(rows)), "report volatility");
+    expect(near(r.riskShares[0] + r.riskShares[1], 1.0), "risk shares sum to 1");
+
+    // Euler : sum_i w_i * d(vol)/d(w_i) = vol
+    expect(near(r.weights[0] * r.marginal[0] + r.weights[1] * r.marginal[1], r.volatility), "marginal Euler identity");
+}
+
+void testPortfolioSnapshot() {
+    Portfolio p = samplePortfolio();
+    const PortfolioSnapshot& s = p.snapshot();
+    expect(s.n == 2, "snapshot size");
+    expect(near(s.totalValue, 4000.0), "snapshot total value");
+    expect(near(s.sigma[0], 0.20) && near(s.sigma[1], 0.05), "snapshot follows asset order");
+    expect(near(s.weight[0], 0.5) && near(s.weight[1], 0.5), "snapshot weights");
+
+    const auto v = p.version();
+    p.addPosition(Asset("BOND", 100.0, 0.02, 0.05), 20.0);
+    expect(p.version() != v, "mutation bumps version");
+    expect(near(p.snapshot().qty[1], 40.0), "snapshot rebuilt after mutation");
+    expect(near(p.snapshot().weight[1], 4000.0 / 6000.0), "snapshot weights rebuilt");
+}
+
+void testRiskKernelVariants() {
+    // n impair pour exercer les restes de boucle vectorielle
+    const std::size_t n = 37;
+    CorrelationMatrix corr(n);
+    std::vector<double> x(n, 0.0);
+    for (std::size_t i = 0; i < n; ++i) {
+        x[i] = 0.01 * static_cast<double>((i * 7) % 11) - 0.03;
+        for (std::size_t j = i + 1; j < n; ++j) {
+            corr.set(i, j, 0.5 * std::sin(static_cast<double>(i * n + j)));
+        }
+    }
+
+    // référence : double boucle pleine
+    double ref = 0.0;
+    std::vector<double> refY(n, 0.0);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) refY[i] += corr(i, j) * x[j];
+        ref += x[i] * refY[i];
+    }
+
+    const KernelIsa initial = activeKernelIsa();
+    for (KernelIsa isa : {KernelIsa::Scalar, KernelIsa::SSE2, KernelIsa::AVX2, KernelIsa::AVX512}) {
+        if (!setKernelIsa(isa)) continue;
+        const std::string tag = kernelIsaName(isa);
+        expect(near(quadFormPacked(corr.data(), x.data(), n), ref, 1e-12), tag + " quadratic form");
+
+        std::vector<double> y(n, 0.0);
+        symvPacked(corr.data(), x.data(), y.data(), n);
+        for (std::size_t i = 0; i < n; ++i) expect(near(y[i], refY[i], 1e-12), tag + " symv");
+    }
+    setKernelIsa(initial);
+}
+
+void testCovarianceEngine() {
+    // T et n non multiples des tuiles, petits blocs et plusieurs threads
+    const std::size_t T = 37;
+    const std::size_t n = 13;
+    std::vector<double> rows(T * n);
+    for (std::size_t t = 0; t < T; ++t)
+        for (std::size_t i = 0; i < n; ++i)
+            rows[t * n + i] = 0.01 * std::sin(0.3 * static_cast<double>(t * (i + 1)) + static_cast<double>(i));
+    for (std::size_t t = 0; t < T; ++t) rows[t * n + 5] = 0.002;   // série constante
+
+    // référence : deux passes par paire
+    std::vector<double> mean(n, 0.0);
+    for (std::size_t t = 0; t < T; ++t)
+        for (std::size_t i = 0; i < n; ++i) mean[i] += rows[t * n + i] / static_cast<double>(T);
+    auto refCov = [&](std::size_t i, std::size_t j) {
+        double s = 0.0;
+        for (std::size_t t = 0; t < T; ++t) s += (rows[t * n + i] - mean[i]) * (rows[t * n + j] - mean[j]);
+        return s / static_cast<double>(T - 1);
+    };
+
+    CovarianceOptions options;
+    options.blockColumns = 4;
+    options.blockRows = 16;
+    options.threads = 3;
+    const KernelIsa initial = activeKernelIsa();
+    for (KernelIsa isa : {KernelIsa::Scalar, KernelIsa::SSE2, KernelIsa::AVX2, KernelIsa::AVX512}) {
+        if (!setKernelIsa(isa)) continue;
+        const std::string tag = kernelIsaName(isa);
+        const CovarianceResult r = computeCovariance(rows.data(), T, n, {}, options);
+        for (std::size_t i = 0; i < n; ++i) {
+            expect(near(r.sigma[i], std::sqrt(refCov(i, i)), 1e-12), tag + " sigma");
+            for (std::size_t j = i; j < n; ++j) {
+                expect(near(r.covariance(i, j), refCov(i, j), 1e-14), tag + " covariance");
+                if (i == j || i == 5 || j == 5) continue;
+                expect(near(r.correlation(i, j), refCov(i, j) / std::sqrt(refCov(i, i) * refCov(j, j)), 1e-12),
+                       tag + " correlation");
+            }
+        }
+        expect(r.correlation(5, 6) == 0.0 && r.correlation(5, 5) == 1.0, tag + " constant series");
+    }
+    setKernelIsa(initial);
+
+    expectThrows<std::invalid_argument>([&] { (void)computeCovariance(rows.data(), 1, n); }, "T < 2");
+}
+
+void testOnlineStats() {
+    // moyenne grande devant l'écart-type : Σx² - (Σx)²/n perdrait tous les chiffres
+    std::vector<double> xs;
+    for (int k = 0; k < 50; ++k) xs.push_back(1e6 + 0.001 * std::sin(0.9 * k));
+    auto twoPassVar = [](const std::vector<double>& v, std::size_t from) {
+        double m = 0.0;
+        for (std::size_t k = from; k < v.size(); ++k) m += v[k];
+        m /= static_cast<double>(v.size() - from);
+        double s = 0.0;
+        for (std::size_t k = from; k < v.size(); ++k) s += (v[k] - m) * (v[k] - m);
+        return s / static_cast<double>(v.size() - from - 1);
+    };
+    RunningStats all, head, tail;
+    for (std::size_t k = 0; k < xs.size(); ++k) {
+        all.add(xs[k]);
+        (k < 20 ? head : tail).add(xs[k]);
+    }
+    expect(near(all.variance(), twoPassVar(xs, 0), 1e-12), "Welford variance");
+    head.merge(tail);
+    expect(head.count() == 50 && near(head.variance(), all.variance(), 1e-12), "merge");
+    for (std::size_t k = 0; k < 10; ++k) all.remove(xs[k]);
+    expect(all.count() == 40 && near(all.variance(), twoPassVar(xs, 10), 1e-12), "rolling remove");
+    RunningStats empty;
+    expectThrows<std::out_of_range>([&] { empty.remove(1.0); }, "remove from empty");
+
+    // co-moments : fenêtre glissante == recalcul complet sur les lignes restantes
+    const std::size_t T = 40;
+    const std::size_t n = 5;
+    std::vector<double> rows(T * n);
+    for (std::size_t t = 0; t < T; ++t)
+        for (std::size_t i = 0; i < n; ++i)
+            rows[t * n + i] = 0.01 * std::cos(0.4 * static_cast<double>(t * (i + 2))) + 0.003 * static_cast<double>(i);
+    RunningCovariance cov(n);
+    for (std::size_t t = 0; t < T; ++t) cov.add(rows.data() + t * n);
+    for (std::size_t t = 0; t < 15; ++t) cov.remove(rows.data() + t * n);
+    const CovarianceResult ref = computeCovariance(rows.data() + 15 * n, T - 15, n);
+    const CorrelationMatrix corr = cov.correlation();
+    for (std::size_t i = 0; i < n; ++i) {
+        expect(near(cov.mean()[i], ref.mean[i], 1e-15), "rolling mean");
+        for (std::size_t j = i; j < n; ++j) {
+            expect(near(cov.covariance(i, j), ref.covariance(i, j), 1e-15), "rolling covariance");
+            expect(near(corr(i, j), ref.correlation(i, j), 1e-12), "rolling correlation");
+        }
+    }
+
+    // EWMA : poids 2^(-k/halfLife) pour l'observation d'âge k
+    const double halfLife = 6.0;
+    EwmaStats ewma(halfLife);
+    EwmaCovariance ewmaCov(n, halfLife);
+    for (std::size_t t = 0; t < T; ++t) {
+        ewma.add(rows[t * n]);
+        ewmaCov.add(rows.data() + t * n);
+    }
+    double W = 0.0;
+    std::vector<double> m(n, 0.0);
+    for (std::size_t t = 0; t < T; ++t) {
+        const double w = std::pow(2.0, -static_cast<double>(T - 1 - t) / halfLife);
+        W += w;
+        for (std::size_t i = 0; i < n; ++i) m[i] += w * rows[t * n + i];
+    }
+    for (double& v : m) v /= W;
+    auto ewmaRef = [&](std::size_t i, std::size_t j) {
+        double s = 0.0;
+        for (std::size_t t = 0; t < T; ++t) {
+            const double w = std::pow(2.0, -static_cast<double>(T - 1 - t) / halfLife);
+            s += w * (rows[t * n + i] - m[i]) * (rows[t * n + j] - m[j]);
+        }
+        return s / W;
+    };
+    expect(near(ewma.mean(), m[0], 1e-15) && near(ewma.variance(), ewmaRef(0, 0), 1e-15), "EWMA mean/variance");
+    const CovarianceMatrix ec = ewmaCov.covariance();
+    for (std::size_t i = 0; i < n; ++i)
+        for (std::size_t j = i; j < n; ++j) expect(near(ec(i, j), ewmaRef(i, j), 1e-15), "EWMA covariance");
+    expectThrows<std::invalid_argument>([] { EwmaStats bad(0.0); }, "halfLife <= 0");
+
+    // flux de prix : log-returns contre la barre précédente, barre invalide ignorée
+    OnlineReturnStats feed({"A", "B"}, 10.0);
+    const double bars[][2] = {{100.0, 50.0}, {101.0, 49.0}, {0.0, 48.0}, {102.0, 50.0}, {100.0, 51.0}};
+    expect(!feed.addPrices(bars[0]), "first bar primes");
+    expect(feed.addPrices(bars[1]) && !feed.addPrices(bars[2]), "invalid bar skipped");
+    feed.addPrices(bars[3]);
+    feed.addPrices(bars[4]);
+    const double r0[] = {std::log(101.0 / 100.0), std::log(102.0 / 101.0), std::log(100.0 / 102.0)};
+    expect(feed.stats(0).count() == 3 && near(feed.stats(0).mean(), (r0[0] + r0[1] + r0[2]) / 3.0, 1e-15), "feed stats");
+    expect(feed.correlation().labels() == std::vector<std::string>({"A", "B"}), "feed labels");
+}
+
+JobInfo waitForJob(const JobQueue& jobs, std::uint64_t id) {
+    for (int i = 0; i < 2000; ++i) {
+        const auto info = jobs.info(id);
+        if (info && info->finished()) return *info;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    throw std::runtime_error("job " + std::to_string(id) + " did not finish");
+}
+
+void testJobQueue() {
+    JobQueue::Options options;
+    options.workers = 1;
+    options.capacity = 2;
+    options.retained = 3;
+    JobQueue jobs(options);
+
+    std::atomic<bool> release{false};
+    std::atomic<bool> started{false};
+    const auto blocker = jobs.submit("block", [&](JobContext& ctx) {
+        started = true;
+        while (!release) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        ctx.progress(0.5);
+        return std::string("blocked");
+    });
+    while (!started) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    expect(jobs.info(blocker.id)->status == JobStatus::Running, "single worker picked the job");
+
+    std::atomic<int> runs{0};
+    auto counted = [&](JobContext&) { ++runs; return std::string("ok"); };
+    const auto first = jobs.submit("same", counted);
+    const auto second = jobs.submit("same", counted);
+    expect(!first.coalesced && second.coalesced && second.id == first.id, "identical in-flight job coalesced");
+    const auto other = jobs.submit("", counted);
+    expect(jobs.info(other.id)->status == JobStatus::Queued, "unkeyed job queued");
+    expectThrows<JobQueueFull>([&] { jobs.submit("third", counted); }, "bounded queue rejects");
+
+    expect(jobs.cancel(other.id), "queued job cancelled");
+    expect(jobs.info(other.id)->status == JobStatus::Cancelled, "cancelled before running");
+    expect(!jobs.cancel(other.id), "cancel is not repeated");
+
+    release = true;
+    expect(waitForJob(jobs, blocker.id).result == "blocked", "blocker result");
+    const JobInfo done = waitForJob(jobs, first.id);
+    expect(done.status == JobStatus::Done && done.result == "ok" && near(done.progress, 1.0), "coalesced job done");
+    expect(runs == 1, "coalesced task ran once");
+    expect(!jobs.submit("same", counted).coalesced, "finished job no longer coalesces");
+
+    const auto failing = jobs.submit("fail", [](JobContext&) -> std::string {
+        throw std::invalid_argument("bad input");
+    });
+    const JobInfo failed = waitForJob(jobs, failing.id);
+    expect(failed.status == JobStatus::Failed && failed.error == "bad input", "failure reported");
+
+    const auto looping = jobs.submit("loop", [](JobContext& ctx) {
+        for (;;) {
+            ctx.checkCancelled();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return std::string();
+    });
+    while (jobs.info(looping.id)->status != JobStatus::Running) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    expect(jobs.cancel(looping.id), "running job cancel signalled");
+    expect(waitForJob(jobs, looping.id).status == JobStatus::Cancelled, "running job stopped cooperatively");
+
+    expect(!jobs.info(blocker.id), "old finished jobs evicted");
+    const auto recent = jobs.recent(2);
+    expect(recent.size() == 2 && recent[0].id == looping.id, "recent jobs newest first");
+
+    const JobQueue::Stats stats = jobs.stats();
+    expect(stats.coalesced == 1 && stats.rejected == 1 && stats.failed == 1 && stats.cancelled == 2,
+           "job queue stats");
+    expectThrows<std::invalid_argument>([&] { jobs.submit("x", JobQueue::Task()); }, "empty task");
+}
+
+void testJsonWriter() {
+    std::string buffer;
+    JsonWriter json(buffer);
+    json.beginObject()
+        .field("name", "A\"B\\C\n\x01")
+        .field("x", 0.1)
+        .field("n", std::int64_t(-42))
+        .field("big", std::uint64_t(18446744073709551615ULL))
+        .field("ok", true)
+        .field("nan", std::nan(""))
+        .key("empty").beginArray().endArray()
+        .key("rows").beginArray()
+        .beginArray().value(1.0).value(-2.5e-7).endArray()
+        .beginObject().endObject()
+        .null()
+        .endArray()
+        .endObject();
+    expect(buffer == "{\"name\":\"A\\\"B\\\\C\\n\\u0001\",\"x\":0.1,\"n\":-42,\"big\":18446744073709551615,"
+                     "\"ok\":true,\"nan\":null,\"empty\":[],\"rows\":[[1,-2.5e-07],{},null]}",
+           "serialized document: " + buffer);
+    expect(json.complete(), "document complete");
+    expectThrows<std::logic_error>([&] { json.endObject(); }, "unbalanced end");
+
+    // tampon réutilisé : clear() garde la capacité
+    const std::size_t capacity = buffer.capacity();
+    buffer.clear();
+    JsonWriter again(buffer);
+    again.beginArray().value("x").value(3).endArray();
+    expect(buffer == "[\"x\",3]" && buffer.capacity() == capacity, "buffer reused");
+
+    std::string escaped;
+    appendJsonEscaped(escaped, "plain");
+    expect(escaped == "plain", "nothing to escape");
+}
+
+void testRiskTrackedMode() {
+    CorrelationMatrix corr = CorrelationMatrix::fromRows(
+        {{1.0, 0.3, -0.2}, {0.3, 1.0, 0.5}, {-0.2, 0.5, 1.0}}, {"AAPL", "BOND", "MSFT"});
+
+    Portfolio p = samplePortfolio();
+    expectThrows<std::invalid_argument>(
+        [&] { p.enableRiskTracking(CorrelationMatrix(2)); }, "tracking requires labels");
+    p.enableRiskTracking(corr, 3);
+    expect(p.riskTracked(), "tracking enabled");
+
+    auto fullVariance = [&](const Portfolio& q) {
+        std::vector<std::string> labels = q.assetOrder();
+        std::vector<std::size_t> idx;
+        for (const auto& name : labels) idx.push_back(name == "AAPL" ? 0 : (name == "BOND" ? 1 : 2));
+        std::vector<std::vector<double>> rows(idx.size(), std::vector<double>(idx.size()));
+        for (std::size_t i = 0; i < idx.size(); ++i)
+            for (std::size_t j = 0; j < idx.size(); ++j) rows[i][j] = corr(idx[i], idx[j]);
+        return q.varianceApprox(rows);
+    };
+
+    expect(near(p.trackedVariance(), fullVariance(p)), "tracked variance initial");
+    p.addPosition(Asset("MSFT", 300.0, 0.08, 0.30), 5.0);
+    expect(near(p.trackedVariance(), fullVariance(p)), "tracked variance after add");
+    p.setPrice("AAPL", 180.0);
+    expect(near(p.trackedVariance(), fullVariance(p)), "tracked variance after price tick");
+    p.removePosition("BOND", 20.0);
+    expect(near(p.trackedVariance(), fullVariance(p)), "tracked variance after removal");
+
+    const auto c = p.trackedContributions();
+    expect(near(c[0] + c[1], p.trackedVariance()), "tracked contributions sum to variance");
+
+    Portfolio copy = p;
+    copy.addPosition(Asset("TSLA", 250.0, 0.15, 0.6), 1.0);
+    expect(!copy.riskTracked() && p.riskTracked(), "asset outside universe leaves tracked mode");
+
+    // what-if d'ajout (mainUI) : position lue en const sur une copie, base intacte
+    Portfolio base = samplePortfolio();
+    base.enableRiskTracking(corr);
+    const double baseVariance = base.trackedVariance();
+    Portfolio simulated = base;
+    const Position* pos = std::as_const(simulated).find("AAPL");
+    expect(pos != nullptr, "what-if position found");
+    simulated.addPosition(pos->asset, 5.0);
+    expect(simulated.riskTracked() && near(simulated.trackedVariance(), fullVariance(simulated)),
+           "tracked variance after what-if add");
+    expect(near(base.trackedVariance(), baseVariance) && near(base.trackedVariance(), fullVariance(base)),
+           "what-if leaves the base portfolio alone");
+    simulated["AAPL"].quantity = 1.0;
+    expect(near(simulated.trackedVariance(), fullVariance(simulated)), "tracked variance after operator[] edit");
+}
+
+void testInternedAssetIds() {
+    auto& symbols = SymbolTable::global();
+    const AssetId id = symbols.intern("INTERN_A");
+    expect(symbols.intern("INTERN_A") == id, "interning is idempotent");
+    expect(symbols.name(id) == "INTERN_A", "id maps back to name");
+    expect(symbols.find("INTERN_UNKNOWN") == kInvalidAssetId, "unknown name has no id");
+
+    Portfolio p;
+    p.addPosition(Asset("INTERN_C", 10.0, 0.05, 0.2), 1.0);
+    p.addPosition(Asset("INTERN_A", 20.0, 0.05, 0.2), 1.0);
+    p.addPosition(Asset("INTERN_B", 30.0, 0.05, 0.2), 1.0);
+    expect(p.find(id) != nullptr && near(p.find(id)->asset.price(), 20.0), "lookup by id");
+    expect(p.positionAt(0).asset.name() == "INTERN_A", "positions in lexical order");
+
+    p.removePosition("INTERN_A", 1.0); // slot libéré par échange avec le dernier
+    expect(p.find(id) == nullptr && p.find("INTERN_A") == nullptr, "removed asset not found");
+    expect(p.assetOrder() == std::vector<std::string>({"INTERN_B", "INTERN_C"}), "order kept after removal");
+    expect(near(p["INTERN_C"].asset.price(), 10.0), "moved slot still reachable by name");
+    expectThrows<std::out_of_range>([&] { (void)p.positionAt(2); }, "positionAt out of range");
+}
+
+void testAssetRegistry() {
+    auto& registry = AssetRegistry::global();
+    const Asset a = registry.registerAsset("REG_A", 100.0, 0.08, 0.20);
+    const Asset b = registry.registerAsset("REG_B", 50.0, 0.03, 0.10);
+    expect(registry.registerAsset("REG_A", 999.0, 0.08, 0.20).sharesRecordWith(a), "same ticker, same handle");
+    expectThrows<std::invalid_argument>(
+        [&] { registry.registerAsset("REG_A", 100.0, 0.09, 0.20); }, "registry parameter mismatch");
+    expectThrows<std::out_of_range>([&] { (void)registry.get("REG_UNKNOWN"); }, "unregistered ticker");
+
+    Portfolio p1;
+    p1.addPosition(a, 10.0);
+    p1.addPosition(b, 20.0);
+    Portfolio p2;
+    p2.addPosition(a, 1.0);
+    const Portfolio merged = p1 + p2;
+    p1.enableRiskTracking(CorrelationMatrix::fromRows({{1.0, 0.4}, {0.4, 1.0}}, {"REG_A", "REG_B"}));
+    expect(near(p1.totalValue(), 2000.0) && near(p2.totalValue(), 100.0), "initial totals");
+
+    const auto v1 = p1.version();
+    registry.setPrice("REG_A", 120.0);   // un seul store pour tous les détenteurs
+    expect(p1.version() != v1, "shared tick bumps version");
+    expect(near(p1.totalValue(), 2200.0), "tick seen by first portfolio");
+    expect(near(p2.totalValue(), 120.0), "tick seen by second portfolio");
+    expect(near(merged.totalValue(), 11.0 * 120.0 + 1000.0), "tick seen by merged portfolio");
+    expect(near(p1.trackedVariance(), p1.varianceApprox({{1.0, 0.4}, {0.4, 1.0}})),
+           "tracked variance follows shared tick");
+
+    p2.setPrice("REG_A", 90.0);   // surcharge locale
+    expect(near(p2.totalValue(), 90.0) && near(p1.totalValue(), 2200.0), "local price stays local");
+    expect(near(registry.get("REG_A").price(), 120.0), "registry price unchanged by local override");
+
+    // nouveau fetch du même ticker : mu/sigma rafraîchis pour tous les détenteurs
+    const Asset refetched = registry.upsert(Asset("REG_B", 52.0, 0.04, 0.12));
+    expect(refetched.sharesRecordWith(b), "upsert keeps the shared handle");
+    expect(near(b.price(), 52.0) && near(b.expectedReturn(), 0.04) && near(b.volatility(), 0.12),
+           "upsert refreshes price, mu and sigma");
+    expect(near(p1.snapshot().sigma[1], 0.12) && near(p1.expectedReturn(), (1200.0 * 0.08 + 1040.0 * 0.04) / 2240.0),
+           "portfolio caches see refreshed parameters");
+    expect(near(p1.trackedVariance(), p1.varianceApprox({{1.0, 0.4}, {0.4, 1.0}})),
+           "tracked variance follows refreshed sigma");
+
+    // tick sur un actif non détenu : version de p2 intacte, celle de p1 bouge
+    const auto v2 = p2.version();
+    const auto v1b = p1.version();
+    registry.setPrice("REG_B", 53.0);
+    expect(p2.version() == v2 && near(p2.totalValue(), 90.0), "tick on an asset not held keeps version");
+    expect(p1.version() != v1b && near(p1.totalValue(), 1200.0 + 20.0 * 53.0), "tick on a held asset bumps version");
+
+    // actif remplacé dans un seul portefeuille : registre et autres détenteurs intacts
+    p1.replaceAsset(Asset("REG_A", 130.0, 0.09, 0.25));
+    expect(near(registry.get("REG_A").price(), 120.0) && near(registry.get("REG_A").volatility(), 0.20),
+           "replaceAsset leaves the shared record alone");
+    expect(near(p1.totalValue(), 1300.0 + 20.0 * 53.0) && near(p1.snapshot().sigma[0], 0.25), "replaced asset used");
+    expect(near(p1.trackedVariance(), p1.varianceApprox({{1.0, 0.4}, {0.4, 1.0}})), "tracked variance after replace");
+    expectThrows<std::out_of_range>([&] { p2.replaceAsset(b); }, "replaceAsset on an asset not held");
+    expect(b.priceEpoch() == assetPriceEpoch() && b.priceEpoch() > a.priceEpoch(), "per-asset epoch");
+}
+
+void testConcurrentSharedTicks() {
+    // un lecteur resynchronise sans arrêt ses caches pendant chaque tick partagé : le tick
+    // ne doit pas se perdre entre la publication de l'époque globale et celle de l'actif
+    const Asset a("TICK_RACE_A", 1.0, 0.05, 0.2);
+    Portfolio p;
+    p.addPosition(a, 2.0);
+    std::atomic<int> phase{0};   // 1 : lecteur actif, 2 : arrêt demandé, 0 : lecteur arrêté
+    std::atomic<bool> quit{false};
+    std::thread reader([&] {
+        while (!quit.load()) {
+            if (phase.load() == 0) continue;
+            while (phase.load() == 1) (void)p.version();
+            phase.store(0);
+        }
+    });
+    bool lost = false;
+    for (int i = 1; i <= 2000 && !lost; ++i) {
+        phase.store(1);
+        Asset(a).setSharedPrice(static_cast<double>(i));
+        phase.store(2);
+        while (phase.load() != 0) std::this_thread::yield();
+        lost = !near(p.totalValue(), 2.0 * i);
+    }
+    quit.store(true);
+    reader.join();
+    expect(!lost, "shared tick seen after a concurrent cache sync");
+}
+
+void testApplyPriceTicks() {
+    auto& symbols = SymbolTable::global();
+    const AssetId aapl = symbols.intern("AAPL");
+    const AssetId bond = symbols.intern("BOND");
+    const AssetId other = symbols.intern("TICK_NOT_HELD");
+
+    Portfolio p = samplePortfolio();   // AAPL 10 x 200, BOND 20 x 100
+    p.enableRiskTracking(CorrelationMatrix::fromRows({{1.0, 0.3}, {0.3, 1.0}}, {"AAPL", "BOND"}));
+    expectThrows<std::invalid_argument>(
+        [&] { p.applyPrices({{aapl, 210.0}, {bond, -1.0}}); }, "negative tick rejected");
+    expect(near(p.find(aapl)->asset.price(), 200.0), "rejected batch leaves prices unchanged");
+    expect(near(p.totalValue(), 4000.0), "initial total");
+
+    const auto moved = p.applyPrices({{aapl, 190.0}, {other, 5.0}, {bond, 100.0}, {aapl, 220.0}});
+    expect(moved.size() == 1 && moved[0] == aapl, "only AAPL moved (last tick wins, same price ignored)");
+    expect(near(p.totalValue(), 4200.0), "total patched");
+    expect(near(p.snapshot().weight[0], 2200.0 / 4200.0), "weights patched");
+    expect(near(p.snapshot().value[0], 2200.0), "value patched");
+    expect(near(p.trackedVariance(), p.varianceApprox({{1.0, 0.3}, {0.3, 1.0}})), "tracked variance after batch");
+    expect(p.applyPrices(std::vector<PriceTick>{}).empty(), "empty batch");
+}
+
+void testPortfolioMerge() {
+    Portfolio a = samplePortfolio();   // AAPL 10 x 200, BOND 20 x 100
+    Portfolio b;
+    b.addPosition(Asset("AAPL", 150.0, 0.10, 0.20), 5.0);
+    b.addPosition(Asset("MSFT", 300.0, 0.08, 0.30), 2.0);
+
+    const Portfolio sum = a + b;
+    expect(sum.size() == 3 && near(sum["AAPL"].quantity, 15.0), "quantities added");
+    expect(near(sum["AAPL"].asset.price(), 200.0), "lhs price kept");
+    expect(a.size() == 2 && b.size() == 2, "const operands untouched");
+
+    Portfolio moved = Portfolio(a) + std::move(b);
+    expect(near(moved.totalValue(), sum.totalValue()), "rvalue overload matches copy overload");
+    expect(b.size() == 0, "moved-from operand emptied");
+
+    Portfolio bad;
+    bad.addPosition(Asset("BOND", 100.0, 0.03, 0.05), 1.0);
+    bad.addPosition(Asset("ZZZ", 1.0, 0.0, 0.1), 1.0);
+    expectThrows<std::invalid_argument>([&] { a.mergeFrom(bad); }, "merge parameter mismatch");
+    expect(a.size() == 2 && near(a.totalValue(), 4000.0), "failed merge leaves target unchanged");
+
+    std::vector<Portfolio> parts(3, samplePortfolio());
+    const Portfolio book = Portfolio::mergeAll(std::move(parts));
+    expect(book.size() == 2 && near(book.totalValue(), 12000.0), "n-way merge");
+}
+
 void testOperatorAccessErrors() {
     Portfolio p;
     expectThrows<std::out_of_range>([&] { (void)p["MISSING"]; }, "operator[] missing asset");
@@ -166,6 +740,21 @@ int main() {
         {"Expected return and volatility", testExpectedReturnAndVolatility},
         {"Correlation matrix errors", testCorrelationMatrixErrors},
         {"Variance contributions", testVarianceContributions},
+        {"Packed correlation matrix", testPackedCorrelationMatrix},
+        {"Validated correlation handle", testValidatedCorrelationHandle},
+        {"Risk report", testRiskReport},
+        {"Portfolio snapshot", testPortfolioSnapshot},
+        {"Risk kernel variants", testRiskKernelVariants},
+        {"Covariance engine", testCovarianceEngine},
+        {"Online statistics", testOnlineStats},
+        {"Job queue", testJobQueue},
+        {"JSON writer", testJsonWriter},
+        {"Risk-tracked mode", testRiskTrackedMode},
+        {"Interned asset ids", testInternedAssetIds},
+        {"Asset registry", testAssetRegistry},
+        {"Concurrent shared ticks", testConcurrentSharedTicks},
+        {"Batch price ticks", testApplyPriceTicks},
+        {"Portfolio merge", testPortfolioMerge},
         {"Operator[] errors", testOperatorAccessErrors},
     };
 
@@ -0,0 +1,21 @@
+#include "YahooMockServer.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+// Rejoue des réponses chart enregistrées : <dir>/<TICKER>.json
+// Usage : yahoo_mock_server <dir> [port]  puis  YAHOO_CHART_URL=http://127.0.0.1:<port>
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <recorded-json-dir> [port]\n";
+        return 1;
+    }
+    const int port = argc > 2 ? std::atoi(argv[2]) : 8081;
+
+    YahooMockServer server(argv[1]);
+    server.start(port);
+    std::cout << "Replaying " << argv[1] << " on " << server.url() << " (Enter to stop)\n";
+    std::cin.get();
+    return 0;
+}
@@ -0,0 +1,668 @@
+#include "ChartJson.hpp"
+#include "MarketDataSource.hpp"
+#include "RollingCorrelation.hpp"
+#include "Yahoo.hpp"
+#include "YahooMockServer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void expect(bool cond, const std::string& msg) {
+    if (!cond) throw std::runtime_error("Assertion failed: " + msg);
+}
+
+template <typename Ex, typename Fn>
+void expectThrows(Fn&& fn, const std::string& msg) {
+    bool thrown = false;
+    try {
+        fn();
+    } catch (const Ex&) {
+        thrown = true;
+    }
+    if (!thrown) throw std::runtime_error("Expected exception not thrown: " + msg);
+}
+
+bool near(double a, double b, double eps = 1e-9) {
+    return std::fabs(a - b) <= eps;
+}
+
+std::vector<double> syntheticCloses(double start, double drift, std::size_t n) {
+    std::vector<double> closes(n);
+    double px = start;
+    for (std::size_t i = 0; i < n; ++i) {
+        closes[i] = px;
+        px *= std::exp(drift + 0.01 * std::sin(0.7 * static_cast<double>(i)));
+    }
+    return closes;
+}
+
+void testEndpointParsing() {
+    const HttpEndpoint a = HttpEndpoint::parse("http://127.0.0.1:8081");
+    expect(a.host == "127.0.0.1" && a.port == 8081 && !a.tls, "http host:port");
+    const HttpEndpoint b = HttpEndpoint::parse("https://query1.finance.yahoo.com/");
+    expect(b.host == "query1.finance.yahoo.com" && b.port == 443 && b.tls, "https default port");
+    expectThrows<std::invalid_argument>([] { HttpEndpoint::parse("ftp://x"); }, "unsupported scheme");
+    expectThrows<std::invalid_argument>([] { HttpEndpoint::parse("http://x:99999"); }, "invalid port");
+}
+
+void testFetchAssetFromMock() {
+    YahooMockServer server;
+    const auto closes = syntheticCloses(100.0, 0.001, 60);
+    server.setChart("MOCK", YahooMockServer::chartJson(closes));
+    server.start();
+    setYahooEndpoint(HttpEndpoint::parse(server.url()));
+
+    const Asset a = fetchAssetFromYahoo("MOCK");
+    expect(a.name() == "MOCK", "asset name");
+    expect(near(a.price(), closes.back()), "price = last close");
+
+    const auto r = fetchDailyLogReturns1y("MOCK");
+    expect(r.size() == closes.size() - 1, "one return per consecutive close");
+    expect(near(r[0], std::log(closes[1] / closes[0])), "log return");
+
+    double mean = 0.0;
+    for (double x : r) mean += x;
+    mean /= static_cast<double>(r.size());
+    expect(near(a.expectedReturn(), mean * 252.0), "annualized mu");
+}
+
+void testKeepAliveReusesConnection() {
+    YahooMockServer server;
+    server.setChart("MOCK", YahooMockServer::chartJson(syntheticCloses(50.0, 0.0005, 40)));
+    server.start();
+    setYahooEndpoint(HttpEndpoint::parse(server.url()));
+
+    for (int i = 0; i < 5; ++i) (void)fetchPriceHistory1y("MOCK");   // réseau, sans cache
+    expect(server.requestCount() == 5, "all requests served");
+    expect(server.connectionCount() == 1, "sequential fetches share one keep-alive connection");
+
+    expectThrows<std::runtime_error>([] { (void)fetchPriceHistory1y("UNKNOWN"); }, "404 surfaces as runtime_error");
+    (void)fetchPriceHistory1y("MOCK");
+    expect(server.requestCount() == 7, "transport still usable after an error status");
+}
+
+void testCorrelationFromMock() {
+    YahooMockServer server;
+    const auto a = syntheticCloses(100.0, 0.001, 60);
+    std::vector<double> b(a);
+    for (double& x : b) x *= 3.0;   // mêmes rendements
+    server.setChart("AAA", YahooMockServer::chartJson(a));
+    server.setChart("BBB", YahooMockServer::chartJson(b));
+    server.start();
+    setYahooEndpoint(HttpEndpoint::parse(server.url()));
+
+    const CorrelationMatrix corr = correlationMatrixFromYahoo({"AAA", "BBB"});
+    expect(corr.size() == 2 && corr.labels() == std::vector<std::string>({"AAA", "BBB"}), "labelled matrix");
+    expect(near(corr(0, 1), 1.0, 1e-12), "identical returns => correlation 1");
+}
+
+void testChartJsonScanner() {
+    const std::string json =
+        "{\"chart\":{\"result\":[{\"meta\":{\"longName\":\"A \\\"close\\\":[9] Inc\",\"chartPreviousClose\":99.5},"
+        "\"timestamp\":[1700000000, 1700086400,1700172800 ,1.7002592E9],"
+        "\"indicators\":{\"quote\":[{\"volume\":[1200,null,3400,5600],\"close\":[ 101.25,null, 1.0325e2,104 ]}],"
+        "\"adjclose\":[{\"adjclose\":[100.5,null,102.5,103.5]}]}}],\"error\":null}}";
+
+    const ChartSeries c = parseChartJson(json);
+    expect(c.hasTimestamps && c.hasCloses, "arrays found");
+    expect(c.timestamps == std::vector<std::int64_t>({1700000000, 1700086400, 1700172800, 1700259200}), "timestamps");
+    expect(c.closes.size() == 4 && c.closes[0] == 101.25 && std::isnan(c.closes[1]) && c.closes[2] == 103.25 && c.closes[3] == 104.0,
+           "closes with positional null");
+    expect(c.adjCloses.size() == 4 && c.adjCloses[3] == 103.5 && std::isnan(c.adjCloses[1]), "nested adjclose");
+    expect(c.volumes.size() == 4 && c.volumes[2] == 3400.0, "volume");
+
+    const ChartSeries empty = parseChartJson("{\"chart\":{\"result\":[{\"meta\":{},\"indicators\":{\"quote\":[{}]}}]}}");
+    expect(!empty.hasTimestamps && empty.closes.empty(), "no bars");
+    expectThrows<std::runtime_error>([] { (void)parseChartJson("{\"close\":[1.0,abc]}"); }, "bad number");
+    expectThrows<std::runtime_error>([] { (void)parseChartJson("{\"close\":[1.0,2.0"); }, "unterminated array");
+}
+
+void testPriceHistorySingleFetch() {
+    YahooMockServer server;
+    std::vector<double> closes = syntheticCloses(40.0, 0.0008, 45);
+    std::string json = YahooMockServer::chartJson(closes);
+    // un close null au 3e jour : retiré avec son timestamp
+    const std::string third = "," + [&] { std::ostringstream os; os.precision(17); os << closes[2]; return os.str(); }() + ",";
+    json.replace(json.find(third), third.size(), ",null,");
+    server.setChart("HIST", json);
+    server.start();
+    setYahooEndpoint(HttpEndpoint::parse(server.url()));
+
+    const PriceHistory h = fetchPriceHistory1y("HIST");
+    expect(server.requestCount() == 1, "one request per history");
+    expect(h.closes.size() == 44 && h.timestamps.size() == 44, "null close dropped with its timestamp");
+    expect(h.timestamps[2] == 1700000000 + 3 * 86400, "timestamps stay aligned");
+    expect(h.logReturns.size() == 43 && h.returnTimestamps.size() == 43, "returns aligned with end dates");
+    expect(near(h.lastPrice, closes.back()), "last price");
+
+    const Asset a = h.toAsset();
+    expect(a.name() == "HIST" && near(a.price(), h.lastPrice) && near(a.volatility(), h.sigma), "asset from history");
+    const CorrelationMatrix corr = correlationMatrixFromHistories({h, h});
+    expect(near(corr(0, 1), 1.0, 1e-12), "correlation from histories");
+    expect(server.requestCount() == 1, "asset and correlation derived without refetch");
+
+    expectThrows<std::invalid_argument>(
+        [] { (void)PriceHistory::fromCloses("X", {1, 2}, {1.0}); }, "timestamps/closes mismatch");
+}
+
+void testHistoryCacheTtlAndCap() {
+    HistoryCache::Clock::time_point now{};
+    HistoryCache::Options options;
+    options.ttl = std::chrono::seconds(60);
+    options.now = [&] { return now; };
+    HistoryCache cache(options);
+
+    int fetches = 0;
+    auto fetch = [&](const std::string& t) {
+        return [&, t] {
+            ++fetches;
+            return PriceHistory::fromCloses(t, std::vector<std::int64_t>(40, 0), syntheticCloses(10.0, 0.001, 40));
+        };
+    };
+
+    const auto a1 = cache.get(HistoryKey{"A"}, fetch("A"));
+    const auto a2 = cache.get(HistoryKey{"A"}, fetch("A"));
+    expect(a1 == a2 && fetches == 1, "second get is a hit");
+    (void)cache.get(HistoryKey{"A", "5d", "1d"}, fetch("A"));
+    expect(fetches == 2, "range is part of the key");
+
+    now += std::chrono::seconds(61);
+    (void)cache.get(HistoryKey{"A"}, fetch("A"));
+    expect(fetches == 3 && cache.stats().expirations == 1, "expired entry refetched");
+
+    expectThrows<std::runtime_error>(
+        [&] { (void)cache.get(HistoryKey{"BAD"}, [] () -> PriceHistory { throw std::runtime_error("down"); }); },
+        "fetch error propagated");
+    expect(cache.stats().entries == 2, "failed fetch not cached");
+
+    HistoryCache::Options small;
+    small.maxBytes = 2 * sizeof(PriceHistory) + 2048;   // ~1 historique de 40 points
+    HistoryCache tiny(small);
+    (void)tiny.get(HistoryKey{"A"}, fetch("A"));
+    (void)tiny.get(HistoryKey{"B"}, fetch("B"));
+    const HistoryCache::Stats st = tiny.stats();
+    expect(st.entries == 1 && st.evictions == 1 && st.bytes <= small.maxBytes, "memory cap evicts LRU entry");
+}
+
+void testHistoryCacheSingleflight() {
+    YahooMockServer server;
+    server.setChart("SF", YahooMockServer::chartJson(syntheticCloses(30.0, 0.0005, 40)));
+    server.setLatencyMs(200);
+    server.start();
+    setYahooEndpoint(HttpEndpoint::parse(server.url()));   // vide aussi le cache
+
+    const HistoryCache::Stats before = yahooHistoryCache().stats();
+    std::vector<std::thread> callers;
+    std::vector<std::shared_ptr<const PriceHistory>> got(6);
+    for (std::size_t i = 0; i < got.size(); ++i) {
+        callers.emplace_back([&, i] { got[i] = cachedPriceHistory(HistoryKey{"SF"}); });
+    }
+    for (auto& t : callers) t.join();
+
+    expect(server.requestCount() == 1, "concurrent requests collapsed into one fetch");
+    for (const auto& h : got) expect(h == got[0], "all callers share the same history");
+    const HistoryCache::Stats st = yahooHistoryCache().stats();
+    expect(st.misses - before.misses == 1 &&
+           (st.hits + st.coalesced) - (before.hits + before.coalesced) == 5, "hit/miss counters");
+
+    (void)fetchAssetFromYahoo("SF");
+    (void)fetchDailyLogReturns1y("SF");
+    expect(server.requestCount() == 1, "asset and returns served from cache");
+}
+
+void testHistoryCacheFollowerTimeout() {
+    HistoryCache cache;
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+    const auto closes = syntheticCloses(50.0, 0.0003, 30);
+    std::thread leader([&] {
+        (void)cache.get(HistoryKey{"FT"}, [&] {
+            gate.wait();
+            return PriceHistory::fromCloses("FT", std::vector<std::int64_t>(closes.size(), 0), closes);
+        });
+    });
+    while (cache.stats().misses == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    const auto t0 = std::chrono::steady_clock::now();
+    expectThrows<std::runtime_error>([&] {
+        (void)cache.get(HistoryKey{"FT"}, [] { return PriceHistory(); }, std::chrono::milliseconds(50));
+    }, "follower gives up after its own timeout");
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    expect(ms < 1000.0, "follower did not wait for the leader");
+
+    release.set_value();
+    leader.join();
+    const auto h = cache.get(HistoryKey{"FT"}, [] { return PriceHistory(); }, std::chrono::milliseconds(50));
+    expect(h && h->closes == closes, "leader result still cached");
+}
+
+void testHistoryStoreWarmStart() {
+    const std::string dir = (std::filesystem::temp_directory_path() / "yahoo_history_store_test").string();
+    std::filesystem::remove_all(dir);
+
+    std::int64_t clock = 1700000000;
+    HistoryStore::Options options;
+    options.maxAgeSeconds = 3600;
+    options.now = [&] { return clock; };
+    auto store = std::make_shared<HistoryStore>(dir, options);
+
+    const auto closes = syntheticCloses(80.0, 0.0004, 50);
+    YahooMockServer server;
+    server.setChart("^GSPC", YahooMockServer::chartJson(closes));
+    server.start();
+    setYahooEndpoint(HttpEndpoint::parse(server.url()));
+    setYahooHistoryStore(store);
+
+    const HistoryKey key{"^GSPC"};
+    const auto cold = cachedPriceHistory(key);
+    expect(server.requestCount() == 1, "cold start hits the network");
+
+    const auto view = store->open(key);
+    expect(view && view->size() == closes.size(), "file written with one row per close");
+    expect(view->closes()[7] == closes[7] && view->timestamps()[0] == cold->timestamps[0], "columns read in place");
+
+    yahooHistoryCache().clear();   // "redémarrage" : plus rien en mémoire
+    const auto warm = cachedPriceHistory(key);
+    expect(server.requestCount() == 1, "warm start served from disk");
+    expect(warm->closes == cold->closes && near(warm->sigma, cold->sigma), "same history after reload");
+
+    clock += 2 * 3600;
+    yahooHistoryCache().clear();
+    (void)cachedPriceHistory(key);
+    expect(server.requestCount() == 2, "stale file refetched");
+
+    {
+        std::ofstream truncate(store->pathFor(key), std::ios::binary | std::ios::trunc);
+        truncate << "PXHIST";
+    }
+    expect(store->open(key) == nullptr, "truncated file rejected");
+
+    setYahooHistoryStore(nullptr);
+    std::filesystem::remove_all(dir);
+}
+
+void testIncrementalTailRefresh() {
+    auto closes = syntheticCloses(40.0, 0.0003, 120);
+    auto ts = YahooMockServer::dailyTimestamps(closes.size());
+    YahooMockServer server;
+    server.setSeries("INC", ts, closes);
+    server.start();
+    setYahooEndpoint(HttpEndpoint::parse(server.url()));
+
+    const HistoryKey key{"INC", "3mo", "1d"};
+    const auto before = cachedPriceHistory(key);
+
+    // dernier close révisé + deux nouvelles séances
+    const std::int64_t last = ts.back();
+    closes.back() *= 1.01;
+    const auto more = syntheticCloses(closes.back(), 0.001, 3);
+    for (std::size_t i = 1; i < more.size(); ++i) {
+        closes.push_back(more[i]);
+        ts.push_back(ts.back() + 86400);
+    }
+    server.setSeries("INC", ts, closes);
+
+    const auto after = refreshPriceHistory(key);
+    expect(server.requestCount() == 2, "one tail request");
+    expect(server.lastTarget().find("period1=" + std::to_string(last)) != std::string::npos, "tail starts at last bar");
+    expect(after != before && cachedPriceHistory(key) == after, "cache holds refreshed history");
+
+    // fenêtre 3mo glissée vers l'avant : même résultat qu'un calcul complet sur la fenêtre
+    const std::int64_t cutoff = ts.back() - 92 * 86400;
+    const std::size_t first = std::lower_bound(ts.begin(), ts.end(), cutoff) - ts.begin();
+    const PriceHistory full = PriceHistory::fromCloses("INC", std::vector<std::int64_t>(ts.begin() + (long)first, ts.end()),
+                                                       std::vector<double>(closes.begin() + (long)first, closes.end()));
+    expect(after->closes == full.closes && after->logReturns.size() == full.logReturns.size(), "window rolled forward");
+    expect(near(after->mu, full.mu, 1e-12) && near(after->sigma, full.sigma, 1e-12), "running mu/sigma");
+
+    expect(refreshPriceHistory(key) == after, "nothing new: history unchanged");
+
+    // longue vie : une séance ajoutée et une retirée à chaque pas, ré-ancrage périodique de returnStats
+    PriceHistory rolling = *after;
+    std::int64_t t = ts.back();
+    double c = closes.back();
+    for (std::size_t k = 0; k < PriceHistory::kStatsRefreshEvery + 100; ++k) {
+        t += 86400;
+        c *= 1.0 + 0.002 * std::sin(0.7 * (double)k);
+        rolling.appendBars({t}, {c}, 92 * 86400);
+    }
+    expect(rolling.statsRemovals < PriceHistory::kStatsRefreshEvery, "return stats re-anchored");
+    const PriceHistory recomputed = PriceHistory::fromCloses("INC", rolling.timestamps, rolling.closes);
+    expect(near(rolling.mu, recomputed.mu, 1e-12) && near(rolling.sigma, recomputed.sigma, 1e-12),
+           "long-lived running mu/sigma");
+}
+
+void testCorrelationTrackerIncremental() {
+    YahooMockServer server;
+    const std::vector<std::string> tickers = {"XA", "XB", "XC"};
+    std::vector<std::vector<double>> closes;
+    for (std::size_t i = 0; i < tickers.size(); ++i) {
+        closes.push_back(syntheticCloses(20.0 + 10.0 * i, 0.0004 * (double)i, 80));
+        server.setSeries(tickers[i], YahooMockServer::dailyTimestamps(80), closes[i]);
+    }
+    server.start();
+    setYahooEndpoint(HttpEndpoint::parse(server.url()));
+
+    YahooCorrelationTracker tracker(tickers);
+    tracker.refresh();
+    expect(!tracker.lastRefreshIncremental() && tracker.windowLength() == 79, "initial build");
+    YahooCorrelationTracker anchored(tickers, {}, 1);   // reconstruction dès le premier retrait
+    anchored.refresh();
+
+    for (std::size_t i = 0; i < tickers.size(); ++i) {
+        closes[i].push_back(closes[i].back() * (1.0 + 0.01 * ((double)i - 1.0)));
+        server.setSeries(tickers[i], YahooMockServer::dailyTimestamps(81), closes[i]);
+    }
+    tracker.refresh();
+    expect(tracker.lastRefreshIncremental() && tracker.windowLength() == 80, "new bar pushed into the sums");
+
+    const CorrelationMatrix full = correlationMatrixFromHistories(tracker.histories());
+    const CorrelationMatrix rolled = tracker.matrix();
+    for (std::size_t i = 0; i < tickers.size(); ++i)
+        for (std::size_t j = 0; j < tickers.size(); ++j)
+            expect(near(rolled(i, j), full(i, j), 1e-10), "cross-sum correlation matches full recompute");
+
+    anchored.refresh();
+    expect(anchored.lastRefreshIncremental(), "no removal: still incremental");
+    for (std::size_t i = 0; i < tickers.size(); ++i) {   // dernier close révisé : une ligne retirée par la fin
+        closes[i].back() *= 1.02;
+        server.setSeries(tickers[i], YahooMockServer::dailyTimestamps(81), closes[i]);
+    }
+    tracker.refresh();
+    anchored.refresh();
+    expect(tracker.lastRefreshIncremental() && !anchored.lastRefreshIncremental(), "rebuilt after rebuildEvery removals");
+    const CorrelationMatrix revised = correlationMatrixFromHistories(anchored.histories());
+    for (std::size_t i = 0; i < tickers.size(); ++i)
+        for (std::size_t j = 0; j < tickers.size(); ++j)
+            expect(near(anchored.matrix()(i, j), revised(i, j), 1e-10) && near(tracker.matrix()(i, j), revised(i, j), 1e-10),
+                   "rebuilt and incremental sums agree");
+}
+
+void testTimestampAlignedReturns() {
+    // même facteur commun, places différentes : US ouvre à 14:30 UTC, Europe à 08:00 UTC,
+    // et chaque place a un jour férié que l'autre n'a pas
+    const std::int64_t day0 = 1700006400;   // minuit UTC
+    const std::size_t days = 60;
+    std::vector<std::int64_t> tsUs, tsEu;
+    std::vector<double> us, eu;
+    double pu = 100.0, pe = 50.0;
+    for (std::size_t d = 0; d < days; ++d) {
+        const double f = 0.01 * std::sin(1.3 * (double)d) + 0.004 * std::cos(0.4 * (double)d);
+        pu *= std::exp(f);
+        pe *= std::exp(2.0 * f);
+        if (d != 17) { tsUs.push_back(day0 + (std::int64_t)d * 86400 + 52200); us.push_back(pu); }
+        if (d != 30) { tsEu.push_back(day0 + (std::int64_t)d * 86400 + 28800); eu.push_back(pe); }
+    }
+    const PriceHistory a = PriceHistory::fromCloses("US", tsUs, us);
+    const PriceHistory b = PriceHistory::fromCloses("EU", tsEu, eu);
+
+    const AlignedReturns inter = AlignedReturns::join({&a, &b});
+    // 59 rendements par série ; le lendemain de chaque férié manque ou couvre deux séances
+    expect(inter.rows() == 57 && inter.series() == 2, "intersection of return dates");
+    expect(inter.timestamps()[0] == day0 + 86400, "rows keyed by UTC day");
+    bool sameDay = true;
+    for (std::size_t t = 0; t < inter.rows(); ++t) {
+        if (inter.timestamps()[t] == day0 + 18 * 86400 || inter.timestamps()[t] == day0 + 31 * 86400) continue;
+        sameDay = sameDay && near(inter(t, 1), 2.0 * inter(t, 0), 1e-12);
+    }
+    expect(sameDay, "returns matched by date, not by position");
+
+    const AlignedReturns pair = AlignedReturns::join({&a, &b}, AlignOptions{MissingReturns::PairwiseComplete});
+    expect(pair.rows() == 59 && std::isnan(pair(16, 0)) && std::isnan(pair(29, 1)), "union keeps gaps as NaN");
+    expect(near(correlationMatrixFromHistories(std::vector<PriceHistory>{a, b})(0, 1), inter.correlation()(0, 1)),
+           "Yahoo correlation uses the aligned matrix");
+
+    const AlignedReturns exact = AlignedReturns::join({&a, &b}, AlignOptions{MissingReturns::Intersection, 0});
+    expect(exact.rows() == 0, "exact timestamps never meet across exchanges");
+    expectThrows<std::runtime_error>([&] { (void)exact.correlation(); }, "no common dates");
+}
+
+void testRollingCorrelationSeries() {
+    // trois séries sur 300 séances, corrélation au facteur commun qui change de régime
+    const std::size_t days = 300;
+    const auto ts = YahooMockServer::dailyTimestamps(days);
+    std::vector<std::vector<double>> closes(3, std::vector<double>(days));
+    double px[3] = {100.0, 50.0, 20.0};
+    for (std::size_t d = 0; d < days; ++d) {
+        const double f = 0.01 * std::sin(0.9 * (double)d);
+        const double e = 0.003 * std::cos(1.7 * (double)d * (double)d);
+        const double beta = d < 150 ? 1.0 : -0.5;
+        px[0] *= std::exp(f);
+        px[1] *= std::exp(beta * f + e);
+        px[2] *= std::exp(0.3 * e + 0.002 * std::sin(0.1 * (double)d));
+        for (std::size_t i = 0; i < 3; ++i) closes[i][d] = px[i];
+    }
+    std::vector<PriceHistory> histories;
+    for (std::size_t i = 0; i < 3; ++i) histories.push_back(PriceHistory::fromCloses("S" + std::to_string(i), ts, closes[i]));
+    const AlignedReturns aligned = AlignedReturns::join({&histories[0], &histories[1], &histories[2]});
+
+    RollingCorrelationOptions options;
+    options.window = 60;
+    options.step = 5;
+    const RollingCorrelationSeries rolling = RollingCorrelationSeries::compute(aligned, options);
+    expect(rolling.steps() == (aligned.rows() - 60) / 5 + 1, "one matrix per step");
+    expect(rolling.timestamps().back() == aligned.timestamps()[59 + 5 * (rolling.steps() - 1)], "indexed by window end");
+
+    for (std::size_t k = 0; k < rolling.steps(); ++k) {
+        // référence : fenêtre recalculée de zéro
+        const CovarianceResult ref = computeCovariance(aligned.row(5 * k), 60, 3);
+        const CorrelationMatrix m = rolling.matrix(k);
+        for (std::size_t i = 0; i < 3; ++i)
+            for (std::size_t j = i + 1; j < 3; ++j) {
+                expect(near(m(i, j), ref.correlation(i, j), 1e-6), "incremental window matches recompute");
+                expect(rolling.pair(j, i)[k] == rolling.pair(i, j)[k], "pair order irrelevant");
+            }
+    }
+    // ré-ancrage périodique : mêmes valeurs que le glissement pur
+    RollingCorrelationOptions anchored = options;
+    anchored.refreshEvery = 7;
+    const RollingCorrelationSeries reanchored = RollingCorrelationSeries::compute(aligned, anchored);
+    expect(reanchored.steps() == rolling.steps(), "same steps when re-anchored");
+    for (std::size_t k = 0; k < rolling.steps(); ++k) {
+        expect(near(reanchored.pair(0, 1)[k], rolling.pair(0, 1)[k], 1e-6) &&
+               near(reanchored.pair(1, 2)[k], rolling.pair(1, 2)[k], 1e-6), "re-anchored window matches");
+    }
+    anchored.refreshEvery = 0;
+    expectThrows<std::invalid_argument>([&] { (void)RollingCorrelationSeries::compute(aligned, anchored); },
+                                        "refreshEvery must be > 0");
+
+    const std::vector<double> s01 = rolling.pairSeries(rolling.indexOf("S0"), rolling.indexOf("S1"));
+    expect(s01.front() > 0.9 && s01.back() < -0.5, "regime change visible in the pair history");
+    expect(rolling.indexOf("NOPE") == rolling.series(), "unknown label");
+    expectThrows<std::invalid_argument>([&] { (void)rolling.pair(1, 1); }, "diagonal pair");
+    expectThrows<std::out_of_range>([&] { (void)rolling.pair(0, 3); }, "pair out of range");
+    expectThrows<std::invalid_argument>([&] {
+        (void)RollingCorrelationSeries::compute(AlignedReturns::join({&histories[0]}, AlignOptions{MissingReturns::PairwiseComplete}));
+    }, "requires intersection");
+    expect(RollingCorrelationSeries::compute(aligned, RollingCorrelationOptions{1000, 1}).steps() == 0, "history shorter than window");
+}
+
+void testConcurrentFetchBoundedAndOrdered() {
+    YahooMockServer server;
+    std::vector<std::string> tickers;
+    for (int i = 0; i < 8; ++i) {
+        const std::string t = "T" + std::to_string(i);
+        tickers.push_back(t);
+        server.setChart(t, YahooMockServer::chartJson(syntheticCloses(10.0 + i, 0.0002 * i, 40)));
+    }
+    server.setLatencyMs(150);
+    server.start();
+    setYahooEndpoint(HttpEndpoint::parse(server.url()));
+
+    YahooFetchOptions options;
+    options.maxInFlight = 4;
+    const auto t0 = std::chrono::steady_clock::now();
+    const auto results = fetchPriceHistories1y(tickers, options);
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    expect(results.size() == tickers.size(), "one result per ticker");
+    for (std::size_t i = 0; i < tickers.size(); ++i) {
+        expect(results[i].ticker == tickers[i] && results[i].ok(), "results in input order");
+    }
+    expect(server.peakInFlight() <= 4, "in-flight limit respected");
+    expect(server.peakInFlight() >= 2, "requests overlap");
+    expect(ms < 8 * 150.0 * 0.75, "faster than sequential round-trips");
+
+    // deux appelants concurrents sous un plafond global de 3 : jamais plus de 3 requêtes
+    YahooMockServer shared;
+    for (const auto& t : tickers) shared.setChart(t, YahooMockServer::chartJson(syntheticCloses(10.0, 0.0001, 40)));
+    shared.setLatencyMs(100);
+    shared.start();
+    setYahooEndpoint(HttpEndpoint::parse(shared.url()));
+    setYahooMaxInFlight(3);
+    options.useCache = false;
+    std::vector<TickerHistory> first;
+    std::thread other([&] { first = fetchPriceHistories1y(tickers, options); });
+    const auto second = fetchPriceHistories1y(tickers, options);
+    other.join();
+    setYahooMaxInFlight(8);
+    for (std::size_t i = 0; i < tickers.size(); ++i) {
+        expect(first[i].ok() && second[i].ok(), "both batches complete");
+    }
+    expect(shared.peakInFlight() <= 3, "global in-flight limit shared by callers");
+    expectThrows<std::invalid_argument>([] { setYahooMaxInFlight(0); }, "zero limit rejected");
+}
+
+void testPartialFailuresPerTicker() {
+    YahooMockServer server;
+    const auto a = syntheticCloses(100.0, 0.001, 60);
+    server.setChart("AAA", YahooMockServer::chartJson(a));
+    server.setChart("SLOW", YahooMockServer::chartJson(a));
+    server.setChart("CCC", YahooMockServer::chartJson(syntheticCloses(20.0, -0.001, 60)));
+    server.setLatencyMs("SLOW", 1500);
+    server.start();
+    setYahooEndpoint(HttpEndpoint::parse(server.url()));
+
+    YahooFetchOptions options;
+    options.timeoutMs = 300;
+    const YahooCorrelationResult r = correlationMatrixFromYahooPartial({"AAA", "SLOW", "MISSING", "CCC"}, options);
+    expect(r.failures.size() == 2, "timeout and 404 reported");
+    expect(r.failures[0].ticker == "SLOW" && r.failures[1].ticker == "MISSING", "failures in input order");
+    expect(r.matrix.labels() == std::vector<std::string>({"AAA", "CCC"}), "matrix over fetched tickers");
+
+    expectThrows<std::runtime_error>(
+        [&] { (void)correlationMatrixFromYahoo({"AAA", "MISSING"}, options); }, "strict variant throws");
+}
+
+void testMarketDataSources() {
+    const auto closes = syntheticCloses(50.0, 0.0005, 60);
+    const auto ts = YahooMockServer::dailyTimestamps(closes.size());
+
+    InMemoryMarketData memory;
+    memory.set("AAA", ts, closes);
+    memory.set("BBB", ts, syntheticCloses(30.0, -0.0002, 60));
+    expect(near(memory.latestPrice("AAA"), closes.back()), "in-memory latest price");
+    const auto batch = memory.histories({"AAA", "NOPE", "BBB"});
+    expect(batch.size() == 3 && batch[0].ok() && !batch[1].ok() && batch[2].ok(), "per-ticker failures in order");
+    const auto quotes = memory.latestPrices({"BBB", "NOPE"});
+    expect(quotes[0].ok() && !quotes[1].ok(), "batch quotes");
+    expect(correlationMatrixFromSource(memory, {"AAA", "BBB"}).labels() ==
+           std::vector<std::string>({"AAA", "BBB"}), "correlation through the interface");
+    expectThrows<std::runtime_error>([&] { (void)correlationMatrixFromSource(memory, {"AAA", "NOPE"}); },
+                                     "strict correlation lists failures");
+
+    const std::string dir = (std::filesystem::temp_directory_path() / "market_data_replay_test").string();
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    {
+        // export Yahoo : 2024-01-01 .. 2024-02-29, colonne Close, une ligne null
+        std::ofstream csv(dir + "/CSV.csv");
+        csv << "Date,Open,High,Low,Close,Adj Close,Volume\n";
+        for (std::size_t i = 0; i < closes.size(); ++i) {
+            const std::size_t day = i < 31 ? i + 1 : i - 30;
+            csv << "2024-" << (i < 31 ? "01-" : "02-") << (day < 10 ? "0" : "") << day << ",1,1,1,";
+            if (i == 45) csv << "null";
+            else csv << std::setprecision(17) << closes[i];
+            csv << ",1,100\n";
+        }
+    }
+    {
+        std::ofstream json(dir + "/JSON.json");
+        json << YahooMockServer::chartJson(ts, closes);
+    }
+    HistoryStore(dir).save(HistoryKey{"PHS"}, *memory.history(HistoryKey{"AAA"}));
+
+    auto files = makeMarketDataSource("file:" + dir);
+    expect(files->name() == "file:" + dir, "file source selected by spec");
+    const auto csv = files->history(HistoryKey{"CSV"});
+    expect(csv->closes.size() == 59 && near(csv->lastPrice, closes.back()), "null close skipped");
+    expect(csv->timestamps[0] == 1704067200, "2024-01-01 read as UTC midnight");
+    expect(files->history(HistoryKey{"JSON"})->closes == closes, "recorded chart replayed");
+    expect(files->history(HistoryKey{"PHS"})->closes == closes, "store file replayed");
+    expect(files->history(HistoryKey{"JSON", "1mo"})->closes.size() < closes.size(), "range window applied");
+    expect(files->history(HistoryKey{"CSV"}) == csv, "files read once");
+    expectThrows<std::runtime_error>([&] { (void)files->history(HistoryKey{"MISSING"}); }, "missing file");
+    expectThrows<std::invalid_argument>([&] { (void)files->history(HistoryKey{"../CSV"}); }, "path escape rejected");
+    std::filesystem::remove_all(dir);
+
+    expectThrows<std::invalid_argument>([] { (void)makeMarketDataSource("ftp:x"); }, "unknown spec");
+    expect(makeMarketDataSource("memory")->name() == "memory", "memory spec");
+
+    YahooMockServer server;
+    server.setChart("YYY", YahooMockServer::chartJson(closes));
+    server.start();
+    setYahooEndpoint(HttpEndpoint::parse(server.url()));
+    auto yahoo = makeMarketDataSource("yahoo");
+    const auto fetched = yahoo->histories({"YYY", "ZZZ"});
+    expect(fetched[0].ok() && fetched[0].history->closes == closes && !fetched[1].ok(), "yahoo source batch");
+
+    auto previous = marketDataSource();
+    const char* argv[] = {"ui", "--data=memory"};
+    expect(configureMarketDataSource(2, const_cast<char**>(argv))->name() == "memory", "--data selects the source");
+    setMarketDataSource(previous);
+}
+
+} // namespace
+
+int main() {
+    int passed = 0;
+    int failed = 0;
+
+    const std::vector<std::pair<std::string, std::function<void()>>> tests = {
+        {"Endpoint parsing", testEndpointParsing},
+        {"Fetch asset from mock server", testFetchAssetFromMock},
+        {"Keep-alive connection reuse", testKeepAliveReusesConnection},
+        {"Correlation from mock server", testCorrelationFromMock},
+        {"Chart JSON scanner", testChartJsonScanner},
+        {"Price history from one fetch", testPriceHistorySingleFetch},
+        {"History cache TTL and memory cap", testHistoryCacheTtlAndCap},
+        {"History cache singleflight", testHistoryCacheSingleflight},
+        {"History cache follower timeout", testHistoryCacheFollowerTimeout},
+        {"History store warm start", testHistoryStoreWarmStart},
+        {"Incremental tail refresh", testIncrementalTailRefresh},
+        {"Correlation tracker (cross sums)", testCorrelationTrackerIncremental},
+        {"Timestamp-aligned returns", testTimestampAlignedReturns},
+        {"Rolling correlation series", testRollingCorrelationSeries},
+        {"Concurrent fetch (bounded, ordered)", testConcurrentFetchBoundedAndOrdered},
+        {"Partial failures per ticker", testPartialFailuresPerTicker},
+        {"Market data sources", testMarketDataSources},
+    };
+
+    for (const auto& [name, fn] : tests) {
+        try {
+            fn();
+            ++passed;
+            std::cout << "[PASS] " << name << "\n";
+        } catch (const std::exception& e) {
+            ++failed;
+            std::cout << "[FAIL] " << name << " -> " << e.what() << "\n";
+        }
+    }
+
+    std::cout << "\nSummary: " << passed << " passed, " << failed << " failed\n";
+    return failed == 0 ? 0 : 1;
+}
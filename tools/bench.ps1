@@ -0,0 +1,29 @@
+$ErrorActionPreference = 'Stop'
+
+$cmd = @(
+  'g++',
+  '-std=c++17', '-O2', '-Wall', '-Wextra', '-pedantic',
+  '-I.',
+  'bench/quadform_bench.cpp', 'CorrelationMatrix.cpp', 'RiskKernels.cpp',
+  '-o', 'quadform_bench.exe'
+)
+
+Write-Host ('Building bench: ' + ($cmd -join ' '))
+& $cmd[0] $cmd[1..($cmd.Length-1)]
+
+Write-Host 'Running bench...'
+.\quadform_bench.exe | Tee-Object -FilePath bench_output.txt
+
+$covCmd = @(
+  'g++',
+  '-std=c++17', '-O2', '-Wall', '-Wextra', '-pedantic',
+  '-I.',
+  'bench/covariance_bench.cpp', 'CovarianceEngine.cpp', 'CorrelationMatrix.cpp', 'RiskKernels.cpp',
+  '-o', 'covariance_bench.exe'
+)
+
+Write-Host ('Building covariance bench: ' + ($covCmd -join ' '))
+& $covCmd[0] $covCmd[1..($covCmd.Length-1)]
+
+Write-Host 'Running covariance bench...'
+.\covariance_bench.exe | Tee-Object -FilePath bench_output.txt -Append
@@ -8,7 +8,7 @@ $cmd = @(
   'g++',
   '-std=c++17', '-O2', '-Wall', '-Wextra', '-pedantic',
   '-D_WIN32_WINNT=0x0A00', '-DWINVER=0x0A00',
-  'Asset.cpp', 'Portfolio.cpp', 'Yahoo.cpp', 'main.cpp',
+  'Asset.cpp', 'Portfolio.cpp', 'CorrelationMatrix.cpp', 'RiskKernels.cpp', 'SymbolTable.cpp', 'AssetRegistry.cpp', 'HttpTransport.cpp', 'ChartJson.cpp', 'OnlineStats.cpp', 'PriceHistory.cpp', 'HistoryCache.cpp', 'HistoryStore.cpp', 'MarketDataSource.cpp', 'RollingCrossSums.cpp', 'AlignedReturns.cpp', 'RollingCorrelation.cpp', 'CovarianceEngine.cpp', 'Yahoo.cpp', 'main.cpp',
   '-o', 'portfolio_cli.exe',
   '-lwinhttp', '-lws2_32'
 )
@@ -0,0 +1,57 @@
+#!/usr/bin/env bash
+# Build Linux/macOS : mêmes sources et options que tools/*.ps1, transport httplib
+# avec TLS (CPPHTTPLIB_OPENSSL_SUPPORT, OpenSSL >= 3.0 : libssl-dev / openssl-devel).
+#   tools/build_linux.sh [cli|ui|test|all] [--run]
+# --run lance le binaire construit (cli, ui) ; test exécute toujours les tests.
+set -euo pipefail
+cd "$(dirname "$0")/.."
+
+TARGET="${1:-all}"
+RUN=0
+[ "${2:-}" = "--run" ] && RUN=1
+
+CXX="${CXX:-g++}"
+# httplib.h 0.32 appelle ses propres API OpenSSL dépréciées : avertissements hors projet
+FLAGS=(-std=c++17 -O2 -Wall -Wextra -pedantic -DCPPHTTPLIB_OPENSSL_SUPPORT -Wno-deprecated-declarations)
+LIBS=(-lssl -lcrypto -lpthread)
+
+CORE=(Asset.cpp Portfolio.cpp CorrelationMatrix.cpp RiskKernels.cpp SymbolTable.cpp AssetRegistry.cpp)
+DATA=(HttpTransport.cpp ChartJson.cpp OnlineStats.cpp PriceHistory.cpp HistoryCache.cpp HistoryStore.cpp
+      MarketDataSource.cpp RollingCrossSums.cpp AlignedReturns.cpp RollingCorrelation.cpp CovarianceEngine.cpp)
+
+build() {
+  echo "Building $1: $CXX ${*:2}"
+  "$CXX" "${@:2}"
+}
+
+cli() {
+  build CLI "${FLAGS[@]}" "${CORE[@]}" "${DATA[@]}" Yahoo.cpp main.cpp -o portfolio_cli "${LIBS[@]}"
+  if [ "$RUN" = 1 ]; then ./portfolio_cli; fi
+}
+
+ui() {
+  build UI "${FLAGS[@]}" "${CORE[@]}" "${DATA[@]}" JobQueue.cpp JsonWriter.cpp Yahoo.cpp mainUI.cpp \
+    -o portfolio_ui "${LIBS[@]}"
+  if [ "$RUN" = 1 ]; then ./portfolio_ui; fi
+}
+
+tests() {
+  build tests "${FLAGS[@]}" -I. tests/asset_portfolio_tests.cpp "${CORE[@]}" CovarianceEngine.cpp OnlineStats.cpp \
+    JobQueue.cpp JsonWriter.cpp -o asset_portfolio_tests -lpthread
+  echo 'Running tests...'
+  ./asset_portfolio_tests
+
+  # transport Yahoo contre le serveur local (tests/YahooMockServer.hpp)
+  build 'transport tests' "${FLAGS[@]}" -I. -Itests tests/yahoo_transport_tests.cpp Asset.cpp CorrelationMatrix.cpp \
+    RiskKernels.cpp SymbolTable.cpp "${DATA[@]}" Yahoo.cpp -o yahoo_transport_tests "${LIBS[@]}"
+  echo 'Running transport tests...'
+  ./yahoo_transport_tests
+}
+
+case "$TARGET" in
+  cli) cli ;;
+  ui) ui ;;
+  test) tests ;;
+  all) tests; cli; ui ;;
+  *) echo "usage: $0 [cli|ui|test|all] [--run]" >&2; exit 2 ;;
+esac
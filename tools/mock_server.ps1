@@ -0,0 +1,22 @@
+param(
+  [Parameter(Mandatory = $true)][string]$Dir,
+  [int]$Port = 8081
+)
+
+$ErrorActionPreference = 'Stop'
+
+$cmd = @(
+  'g++',
+  '-std=c++17', '-O2', '-Wall', '-Wextra', '-pedantic',
+  '-D_WIN32_WINNT=0x0A00', '-DWINVER=0x0A00',
+  '-I.', '-Itests',
+  'tests/yahoo_mock_server.cpp',
+  '-o', 'yahoo_mock_server.exe',
+  '-lws2_32'
+)
+
+Write-Host ('Building mock server: ' + ($cmd -join ' '))
+& $cmd[0] $cmd[1..($cmd.Length-1)]
+
+# puis dans un autre terminal : $env:YAHOO_CHART_URL = "http://127.0.0.1:$Port"
+.\yahoo_mock_server.exe $Dir $Port
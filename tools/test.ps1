@@ -4,7 +4,7 @@ $cmd = @(
   'g++',
   '-std=c++17', '-O2', '-Wall', '-Wextra', '-pedantic',
   '-I.',
-  'tests/asset_portfolio_tests.cpp', 'Asset.cpp', 'Portfolio.cpp',
+  'tests/asset_portfolio_tests.cpp', 'Asset.cpp', 'Portfolio.cpp', 'CorrelationMatrix.cpp', 'RiskKernels.cpp', 'SymbolTable.cpp', 'AssetRegistry.cpp', 'CovarianceEngine.cpp', 'OnlineStats.cpp', 'JobQueue.cpp', 'JsonWriter.cpp',
   '-o', 'asset_portfolio_tests.exe'
 )
 
@@ -13,3 +13,20 @@ Write-Host ('Building tests: ' + ($cmd -join ' '))
 
 Write-Host 'Running tests...'
 .\asset_portfolio_tests.exe
+
+# transport Yahoo contre le serveur local (tests/YahooMockServer.hpp)
+$yahooCmd = @(
+  'g++',
+  '-std=c++17', '-O2', '-Wall', '-Wextra', '-pedantic',
+  '-D_WIN32_WINNT=0x0A00', '-DWINVER=0x0A00',
+  '-I.', '-Itests',
+  'tests/yahoo_transport_tests.cpp', 'Asset.cpp', 'CorrelationMatrix.cpp', 'RiskKernels.cpp', 'SymbolTable.cpp', 'HttpTransport.cpp', 'ChartJson.cpp', 'OnlineStats.cpp', 'PriceHistory.cpp', 'HistoryCache.cpp', 'HistoryStore.cpp', 'MarketDataSource.cpp', 'RollingCrossSums.cpp', 'AlignedReturns.cpp', 'RollingCorrelation.cpp', 'CovarianceEngine.cpp', 'Yahoo.cpp',
+  '-o', 'yahoo_transport_tests.exe',
+  '-lwinhttp', '-lws2_32'
+)
+
+Write-Host ('Building transport tests: ' + ($yahooCmd -join ' '))
+& $yahooCmd[0] $yahooCmd[1..($yahooCmd.Length-1)]
+
+Write-Host 'Running transport tests...'
+.\yahoo_transport_tests.exe